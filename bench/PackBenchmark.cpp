@@ -0,0 +1,602 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#include <boost/crc.hpp>
+#include <boost/endian/conversion.hpp>
+#include <core/ModPack.hpp>
+#include <core/ModPackManager.hpp>
+#include <core/PackCache.hpp>
+#include <core/ParallelFor.hpp>
+
+using namespace MCPacker;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    /// @brief Shape of a synthetic pack: number of mods, median size of a mod in KiB
+    /// and the spread of mods' sizes, which follow a log-normal distribution, in tenths
+    using PackShape = std::tuple<int64_t, int64_t, int64_t>;
+
+    constexpr uint64_t KiB = 1024;
+    constexpr uint64_t MinModSize = 4 * KiB, MaxModSize = 64 * KiB * KiB;
+
+    int64_t ReadSetting(const char* name, int64_t fallback)
+    {
+        const char* value = std::getenv(name);
+        return value != nullptr ? std::atoll(value) : fallback;
+    }
+
+    /// @brief Packs the benchmarks run on, `MCPACKER_BENCH_MODS`, `MCPACKER_BENCH_MOD_SIZE` (median, in KiB)
+    /// and `MCPACKER_BENCH_SIZE_SPREAD` (in tenths) replace the default ones with a single custom pack
+    void PackShapes(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"mods", "medianKiB", "spread"});
+        if (std::getenv("MCPACKER_BENCH_MODS") != nullptr or std::getenv("MCPACKER_BENCH_MOD_SIZE") != nullptr)
+        {
+            benchmark->Args({ReadSetting("MCPACKER_BENCH_MODS", 64), ReadSetting("MCPACKER_BENCH_MOD_SIZE", 256),
+                ReadSetting("MCPACKER_BENCH_SIZE_SPREAD", 10)});
+            return;
+        }
+        benchmark->Args({16, 64, 5});
+        benchmark->Args({64, 256, 10});
+        benchmark->Args({256, 512, 10});
+        benchmark->Args({2000, 16, 5});
+    }
+
+    template<typename T>
+    void Put(std::vector<Byte>& out, T value)
+    {
+        const auto position = out.size();
+        out.resize(position + sizeof(T));
+        boost::endian::endian_store<T, sizeof(T), boost::endian::order::little>(
+            reinterpret_cast<unsigned char*>(out.data() + position), value);
+    }
+
+    /// @brief Build a jar with `manifest` as its `fabric.mod.json` and `size` bytes of incompressible data, both stored uncompressed
+    std::vector<Byte> MakeJar(const std::string& manifest, uint64_t size, std::mt19937_64& random)
+    {
+        std::vector<Byte> payload(size);
+        for (size_t i = 0; i < payload.size(); i += sizeof(uint64_t))
+        {
+            const auto word = random();
+            std::memcpy(payload.data() + i, &word, std::min(sizeof(word), payload.size() - i));
+        }
+
+        const std::array<std::pair<std::string, std::span<const Byte>>, 2> files = {{
+            {"fabric.mod.json", std::span(manifest.data(), manifest.size())},
+            {"data.bin", payload}
+        }};
+
+        std::vector<Byte> jar;
+        jar.reserve(size + 1024);
+        std::vector<Byte> centralDirectory;
+        for (const auto& [name, data] : files)
+        {
+            boost::crc_32_type crc;
+            crc.process_bytes(data.data(), data.size());
+            const auto offset = static_cast<uint32_t>(jar.size());
+
+            Put<uint32_t>(jar, 0x04034b50);
+            Put<uint16_t>(jar, 10);
+            Put<uint16_t>(jar, 0);
+            Put<uint16_t>(jar, 0);
+            Put<uint32_t>(jar, 0);
+            Put<uint32_t>(jar, crc.checksum());
+            Put<uint32_t>(jar, static_cast<uint32_t>(data.size()));
+            Put<uint32_t>(jar, static_cast<uint32_t>(data.size()));
+            Put<uint16_t>(jar, static_cast<uint16_t>(name.size()));
+            Put<uint16_t>(jar, 0);
+            jar.insert(std::end(jar), std::begin(name), std::end(name));
+            jar.insert(std::end(jar), std::begin(data), std::end(data));
+
+            Put<uint32_t>(centralDirectory, 0x02014b50);
+            Put<uint16_t>(centralDirectory, 10);
+            Put<uint16_t>(centralDirectory, 10);
+            Put<uint16_t>(centralDirectory, 0);
+            Put<uint16_t>(centralDirectory, 0);
+            Put<uint32_t>(centralDirectory, 0);
+            Put<uint32_t>(centralDirectory, crc.checksum());
+            Put<uint32_t>(centralDirectory, static_cast<uint32_t>(data.size()));
+            Put<uint32_t>(centralDirectory, static_cast<uint32_t>(data.size()));
+            Put<uint16_t>(centralDirectory, static_cast<uint16_t>(name.size()));
+            Put<uint16_t>(centralDirectory, 0);
+            Put<uint16_t>(centralDirectory, 0);
+            Put<uint16_t>(centralDirectory, 0);
+            Put<uint16_t>(centralDirectory, 0);
+            Put<uint32_t>(centralDirectory, 0);
+            Put<uint32_t>(centralDirectory, offset);
+            centralDirectory.insert(std::end(centralDirectory), std::begin(name), std::end(name));
+        }
+
+        const auto centralDirectoryOffset = static_cast<uint32_t>(jar.size());
+        jar.insert(std::end(jar), std::begin(centralDirectory), std::end(centralDirectory));
+        Put<uint32_t>(jar, 0x06054b50);
+        Put<uint16_t>(jar, 0);
+        Put<uint16_t>(jar, 0);
+        Put<uint16_t>(jar, static_cast<uint16_t>(files.size()));
+        Put<uint16_t>(jar, static_cast<uint16_t>(files.size()));
+        Put<uint32_t>(jar, static_cast<uint32_t>(centralDirectory.size()));
+        Put<uint32_t>(jar, centralDirectoryOffset);
+        Put<uint16_t>(jar, 0);
+        return jar;
+    }
+
+    /// @brief Build the `modNumber`-th jar of a synthetic pack, which depends on the one before it
+    std::vector<Byte> MakeJar(size_t modNumber, uint64_t size, std::mt19937_64& random)
+    {
+        const auto id = "mod" + std::to_string(modNumber);
+        const auto dependency = modNumber == 0 ? std::string() : "\"mod" + std::to_string(modNumber - 1) + "\": \">=1.0\"";
+        const auto manifest = "{\"schemaVersion\": 1, \"id\": \"" + id + "\", \"version\": \"1.0." + std::to_string(modNumber)
+            + "\", \"depends\": {\"minecraft\": \"1.20.x\"" + (dependency.empty() ? "" : ", " + dependency) + "}}";
+        return MakeJar(manifest, size, random);
+    }
+
+    /// @brief Synthetic jars and packs, generated once per shape and removed when the benchmarks exit.
+    /// They live in `MCPACKER_BENCH_DIR`, or the temporary directory if it is not set
+    class Workspace
+    {
+    public:
+        struct Pack
+        {
+            std::vector<fs::path> jars;
+            uint64_t totalSize;
+            fs::path packFile;
+        };
+
+    private:
+        fs::path root;
+        std::map<PackShape, Pack> packs;
+
+        Workspace()
+            :
+            root(),
+            packs()
+        {
+            const char* directory = std::getenv("MCPACKER_BENCH_DIR");
+            root = (directory != nullptr ? fs::path(directory) : fs::temp_directory_path()) / ("mcpacker-bench-" + std::to_string(getpid()));
+            fs::create_directories(root);
+        }
+
+    public:
+        ~Workspace()
+        {
+            std::error_code error;
+            fs::remove_all(root, error);
+        }
+
+        static Workspace& Instance()
+        {
+            static Workspace workspace;
+            return workspace;
+        }
+
+        fs::path MakeDirectory(const std::string& name) const
+        {
+            const auto directory = root / name;
+            fs::remove_all(directory);
+            fs::create_directories(directory);
+            return directory;
+        }
+
+        /// @brief Jars of a pack of the given shape and the pack written from them without compression
+        const Pack& GetPack(const PackShape& shape)
+        {
+            const auto [modCount, medianKiB, spread] = shape;
+            const auto found = packs.find(shape);
+            if (found != std::end(packs))
+            {
+                return found->second;
+            }
+
+            const auto directory = MakeDirectory("pack-" + std::to_string(modCount) + "-" + std::to_string(medianKiB) + "-" + std::to_string(spread));
+            Pack pack;
+            pack.totalSize = 0;
+
+            std::mt19937_64 random(static_cast<uint64_t>(modCount * 1000003 + medianKiB));
+            std::lognormal_distribution<double> sizes(std::log(static_cast<double>(medianKiB * KiB)), static_cast<double>(spread) / 10.0);
+            fs::create_directories(directory / "jars");
+            for (int64_t i = 0; i < modCount; ++i)
+            {
+                const auto size = std::clamp(static_cast<uint64_t>(sizes(random)), MinModSize, MaxModSize);
+                const auto jar = MakeJar(static_cast<size_t>(i), size, random);
+                pack.jars.push_back(directory / "jars" / ("mod" + std::to_string(i) + ".jar"));
+                std::ofstream(pack.jars.back(), std::ios::binary).write(jar.data(), static_cast<std::streamsize>(jar.size()));
+                pack.totalSize += jar.size();
+            }
+
+            ModPack(U"Benchmark", U"Synthetic pack", pack.jars).WriteToFile(directory);
+            pack.packFile = directory / "Benchmark.pck";
+            return packs.emplace(shape, std::move(pack)).first->second;
+        }
+    };
+
+    /// @brief Make the kernel start measuring the peak resident memory anew
+    void ResetPeakRSS()
+    {
+        std::ofstream("/proc/self/clear_refs") << "5";
+    }
+
+    /// @brief Peak resident memory since the last `ResetPeakRSS` in MiB, it includes the synthetic data kept in memory
+    double GetPeakRSS()
+    {
+        std::ifstream status("/proc/self/status");
+        for (std::string line; std::getline(status, line); )
+        {
+            if (line.starts_with("VmHWM:"))
+            {
+                return static_cast<double>(std::atoll(line.c_str() + 6)) / 1024.0;
+            }
+        }
+        return 0.0;
+    }
+
+    PackShape GetShape(const benchmark::State& state)
+    {
+        return {state.range(0), state.range(1), state.range(2)};
+    }
+
+    /// @param bytesPerIteration Amount of mods' data processed, 0 for operations which only touch metadata
+    void Report(benchmark::State& state, uint64_t bytesPerIteration, uint64_t modsPerIteration)
+    {
+        if (bytesPerIteration != 0)
+        {
+            state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytesPerIteration));
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * modsPerIteration));
+        state.counters["peakRSS_MiB"] = GetPeakRSS();
+    }
+
+    /// @brief Drop the file from the page cache, so the next read goes to the disk
+    void Evict(const fs::path& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd != -1)
+        {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+
+    /// @brief Build a pack from jars which are not in the page cache, reading `workers` of them at a time
+    /// or all of them through `IoRing`
+    void Ingest(benchmark::State& state, unsigned workers, bool ioRing)
+    {
+        const auto& source = Workspace::Instance().GetPack(GetShape(state));
+        ModPack::IngestOptions options;
+        options.workers = workers;
+        options.ioRing = ioRing;
+
+        ResetPeakRSS();
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            std::ranges::for_each(source.jars, Evict);
+            state.ResumeTiming();
+
+            ModPack pack(U"Ingested", U"Synthetic pack", source.jars, options);
+            benchmark::DoNotOptimize(pack);
+        }
+        Report(state, source.totalSize, source.jars.size());
+    }
+
+    void WriteToFile(benchmark::State& state, const CompressionOptions& compression)
+    {
+        const auto& source = Workspace::Instance().GetPack(GetShape(state));
+        const ModPack pack(U"Written", U"Synthetic pack", source.jars);
+        const auto directory = Workspace::Instance().MakeDirectory("written");
+
+        ResetPeakRSS();
+        for (auto _ : state)
+        {
+            pack.WriteToFile(directory, compression);
+        }
+        Report(state, source.totalSize, source.jars.size());
+    }
+
+    void WriteToFileStored(benchmark::State& state)
+    {
+        WriteToFile(state, CompressionOptions());
+    }
+
+    void WriteToFileZstd(benchmark::State& state)
+    {
+        WriteToFile(state, CompressionOptions(Codec::Zstd, 3, 0));
+    }
+
+    void Read(benchmark::State& state, Utility::ReadingMode readingMode)
+    {
+        const auto& source = Workspace::Instance().GetPack(GetShape(state));
+
+        ResetPeakRSS();
+        for (auto _ : state)
+        {
+            ModPack pack(source.packFile, readingMode);
+            benchmark::DoNotOptimize(pack);
+        }
+        Report(state, readingMode == Utility::ReadingMode::Full ? fs::file_size(source.packFile) : 0, source.jars.size());
+    }
+
+    void ReadFull(benchmark::State& state)
+    {
+        Read(state, Utility::ReadingMode::Full);
+    }
+
+    void ReadMetaInfo(benchmark::State& state)
+    {
+        Read(state, Utility::ReadingMode::OnlyMetaInfo);
+    }
+
+    void Deploy(benchmark::State& state, bool incremental, bool ioRing = true)
+    {
+        const auto& source = Workspace::Instance().GetPack(GetShape(state));
+        const ModPack pack(source.packFile, Utility::ReadingMode::OnlyMetaInfo);
+        const auto directory = Workspace::Instance().MakeDirectory("deployed");
+        ModPack::DeployOptions options;
+        options.incremental = incremental;
+        options.ioRing = ioRing;
+        if (incremental)
+        {
+            pack.Deploy(directory, options);
+        }
+
+        ResetPeakRSS();
+        for (auto _ : state)
+        {
+            auto report = pack.Deploy(directory, options);
+            benchmark::DoNotOptimize(report);
+        }
+        // An incremental deploy of an unchanged directory only compares the mods with the deploy manifest
+        Report(state, incremental ? 0 : source.totalSize, source.jars.size());
+    }
+
+    void DeployFull(benchmark::State& state)
+    {
+        Deploy(state, false);
+    }
+
+    /// @brief Full deploy with every mod extracted by the workers, as on kernels without `io_uring`
+    void DeployFullWorkers(benchmark::State& state)
+    {
+        Deploy(state, false, false);
+    }
+
+    void DeployIncremental(benchmark::State& state)
+    {
+        Deploy(state, true);
+    }
+
+    /// @brief Write jars whose manifests make the resolver report a missing dependency, a conflict and a duplicate
+    std::vector<fs::path> MakeProblemJars(const fs::path& directory)
+    {
+        const std::array<std::string, 3> manifests = {
+            R"({"schemaVersion": 1, "id": "first", "version": "1.0", "depends": {"absent": "*"}})",
+            R"({"schemaVersion": 1, "id": "second", "version": "1.0", "breaks": {"first": "*"}})",
+            R"({"schemaVersion": 1, "id": "first", "version": "1.1"})"
+        };
+
+        std::mt19937_64 random(manifests.size());
+        std::vector<fs::path> jars;
+        for (size_t i = 0; i < manifests.size(); ++i)
+        {
+            const auto jar = MakeJar(manifests[i], MinModSize, random);
+            jars.push_back(directory / ("problem" + std::to_string(i) + ".jar"));
+            std::ofstream(jars.back(), std::ios::binary).write(jar.data(), static_cast<std::streamsize>(jar.size()));
+        }
+        return jars;
+    }
+
+    /// @brief Write `jars` into `packFile` as packs were written before the index: a zero-padded header
+    /// followed by every mod's zero-padded name, big-endian size and data
+    void WriteLegacyPack(const fs::path& packFile, const std::vector<fs::path>& jars)
+    {
+        std::ofstream pack(packFile, std::ios::binary);
+        const std::string name = "Legacy";
+        std::vector<Byte> header((ModPack::MetaInfo::NameLength + ModPack::MetaInfo::DescriptionLength) * sizeof(char32_t), Byte(0));
+        std::ranges::copy(name, std::begin(header));
+        pack.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+        for (const auto& jar : jars)
+        {
+            std::vector<Byte> record(Mod::MetaInfo::NameLengthInBytes, Byte(0));
+            std::ranges::copy(jar.filename().string(), std::begin(record));
+            std::ranges::copy(Utility::ToByteArray<uint64_t>(fs::file_size(jar)), std::back_inserter(record));
+            pack.write(record.data(), static_cast<std::streamsize>(record.size()));
+            pack << std::ifstream(jar, std::ios::binary).rdbuf();
+        }
+    }
+
+    /// @brief Resolve the dependencies of a pack read without mods' data whose index predates manifests,
+    /// so every jar is loaded from the file. Either a legacy pack or a current one restored as from `PackCache`
+    /// with a `PackIndex::CompactVersion` index is used. The benchmark fails unless the missing dependency,
+    /// the conflict and the duplicate planted into the pack are all reported
+    void ResolveWithoutManifests(benchmark::State& state, bool legacy)
+    {
+        using Kind = DependencyResolver::Problem::Kind;
+
+        const auto directory = Workspace::Instance().MakeDirectory(legacy ? "resolve-legacy" : "resolve-compact");
+        const auto jars = MakeProblemJars(directory);
+        std::optional<ModPack> pack;
+        if (legacy)
+        {
+            WriteLegacyPack(directory / "Legacy.pck", jars);
+            pack.emplace(directory / "Legacy.pck", Utility::ReadingMode::OnlyMetaInfo);
+        }
+        else
+        {
+            ModPack(U"Compact", U"Synthetic pack", jars).WriteToFile(directory);
+            const ModPack current(directory / "Compact.pck", Utility::ReadingMode::OnlyMetaInfo);
+            PackIndex older(PackIndex::CompactVersion);
+            for (auto entry : current.GetIndex())
+            {
+                entry.manifest.reset();
+                older.Add(std::move(entry));
+            }
+            pack.emplace(directory / "Compact.pck", current.GetMetaInfo(), std::move(older));
+        }
+
+        const auto resolved = pack->ResolveDependencies();
+        std::set<Kind> reported;
+        for (const auto& problem : resolved.GetProblems())
+        {
+            reported.insert(problem.kind);
+        }
+        if (not reported.contains(Kind::MissingDependency) or not reported.contains(Kind::Conflict) or not reported.contains(Kind::Duplicate))
+        {
+            state.SkipWithError("Problems of a pack without manifests in its index are not reported");
+            return;
+        }
+
+        ResetPeakRSS();
+        for (auto _ : state)
+        {
+            auto resolver = pack->ResolveDependencies();
+            benchmark::DoNotOptimize(resolver);
+        }
+        Report(state, 0, jars.size());
+    }
+
+    /// @brief Directory with `packCount` copies of a pack, laid out like the one `ModPackManager` reads
+    fs::path MakePacksDirectory(const benchmark::State& state, size_t packCount)
+    {
+        const auto& source = Workspace::Instance().GetPack(GetShape(state));
+        const auto directory = Workspace::Instance().MakeDirectory("discovery");
+        fs::create_directories(directory / "packs");
+        for (size_t i = 0; i < packCount; ++i)
+        {
+            fs::copy_file(source.packFile, directory / "packs" / ("Pack" + std::to_string(i) + ".pck"));
+        }
+        return directory;
+    }
+
+    std::vector<fs::path> ListPacks(const fs::path& directory)
+    {
+        std::vector<fs::path> packFiles;
+        for (const auto& entry : fs::directory_iterator(directory))
+        {
+            if (entry.path().extension() == ".pck")
+            {
+                packFiles.push_back(entry.path());
+            }
+        }
+        return packFiles;
+    }
+
+    /// @brief What `ModPackManager` does at startup when the cache is missing: read the metadata of every pack
+    void DiscoverCold(benchmark::State& state)
+    {
+        const auto packs = MakePacksDirectory(state, static_cast<size_t>(state.range(3))) / "packs";
+
+        ResetPeakRSS();
+        for (auto _ : state)
+        {
+            const auto packFiles = ListPacks(packs);
+            std::vector<std::optional<ModPack>> read(packFiles.size());
+            ParallelFor(packFiles.size(), 0,
+                [&](size_t i)
+                {
+                    read[i].emplace(packFiles[i], Utility::ReadingMode::OnlyMetaInfo);
+                });
+            benchmark::DoNotOptimize(read);
+        }
+        Report(state, 0, static_cast<uint64_t>(state.range(3)));
+    }
+
+    /// @brief What `ModPackManager` does at startup when no pack has changed since the last run
+    void DiscoverWarm(benchmark::State& state)
+    {
+        const auto packs = MakePacksDirectory(state, static_cast<size_t>(state.range(3))) / "packs";
+        PackCache cache;
+        for (const auto& packFile : ListPacks(packs))
+        {
+            const auto status = PackCache::Stat(packFile);
+            cache.Set(packFile, status.value(), ModPack(packFile, Utility::ReadingMode::OnlyMetaInfo));
+        }
+        cache.Save(packs);
+
+        ResetPeakRSS();
+        for (auto _ : state)
+        {
+            const auto loaded = PackCache::Load(packs);
+            for (const auto& packFile : ListPacks(packs))
+            {
+                auto pack = loaded.Find(packFile, PackCache::Stat(packFile).value());
+                benchmark::DoNotOptimize(pack);
+            }
+        }
+        Report(state, 0, static_cast<uint64_t>(state.range(3)));
+    }
+
+    /// @brief Startup of the manager itself, which only ever happens once per process
+    void ManagerStartup(benchmark::State& state)
+    {
+        const auto directory = MakePacksDirectory(state, static_cast<size_t>(state.range(3)));
+        const auto workingDirectory = fs::current_path();
+        fs::current_path(directory);
+
+        ResetPeakRSS();
+        for (auto _ : state)
+        {
+            ModPackManager::Instance().WaitUntilLoaded();
+        }
+        fs::current_path(workingDirectory);
+        Report(state, 0, static_cast<uint64_t>(state.range(3)));
+    }
+
+    /// @brief Many small packs, as `ModPackManager` finds in a directory collected over time
+    void DiscoveryShapes(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({"mods", "medianKiB", "spread", "packs"});
+        benchmark->Args({ReadSetting("MCPACKER_BENCH_MODS", 200), ReadSetting("MCPACKER_BENCH_MOD_SIZE", 4),
+            ReadSetting("MCPACKER_BENCH_SIZE_SPREAD", 5), ReadSetting("MCPACKER_BENCH_PACKS", 100)});
+    }
+}
+
+BENCHMARK_CAPTURE(Ingest, Serial, 1u, false)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Ingest, Concurrent, 8u, false)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Ingest, IoRing, 1u, true)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(WriteToFileStored)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(WriteToFileZstd)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(ReadFull)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(ReadMetaInfo)->Apply(PackShapes)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(DeployFull)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(DeployFullWorkers)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(DeployIncremental)->Apply(PackShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(ResolveWithoutManifests, Legacy, true)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK_CAPTURE(ResolveWithoutManifests, Compact, false)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(DiscoverCold)->Apply(DiscoveryShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(DiscoverWarm)->Apply(DiscoveryShapes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(ManagerStartup)->Apply(DiscoveryShapes)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(1);
\ No newline at end of file
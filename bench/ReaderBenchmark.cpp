@@ -0,0 +1,148 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#include <core/FileReader.hpp>
+
+using namespace MCPacker;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    fs::path GetInputPath(int64_t size)
+    {
+        const char* directory = std::getenv("MCPACKER_BENCH_DIR");
+        return (directory != nullptr ? fs::path(directory) : fs::temp_directory_path())
+            / ("mcpacker-reader-" + std::to_string(getpid()) + "-" + std::to_string(size) + ".jar");
+    }
+
+    /// @brief File of the benchmark's argument size, removed when the benchmark ends
+    class InputFile
+    {
+    private:
+        fs::path path;
+
+    public:
+        InputFile(int64_t size)
+            :
+            path(GetInputPath(size))
+        {
+            std::vector<Byte> data(static_cast<size_t>(size));
+            std::ranges::generate(data, [value = 0u]() mutable { return static_cast<Byte>(value++ * 2654435761u >> 24); });
+            OutputBinaryFile file(path, std::ios::binary | std::ios::trunc);
+            file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+        ~InputFile()
+        {
+            fs::remove(path);
+        }
+
+        const fs::path& GetPath() const
+        {
+            return path;
+        }
+
+        /// @brief Drop the file from the page cache, so the next read goes to the disk
+        void Evict() const
+        {
+            const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd != -1)
+            {
+                fdatasync(fd);
+                posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+                close(fd);
+            }
+        }
+    };
+
+    /// @brief Call `read(path)` every iteration, with the file evicted from the page cache beforehand if `cold`
+    template<typename Read>
+    void ReadFile(benchmark::State& state, bool cold, Read read)
+    {
+        const InputFile input(state.range(0));
+        for (auto _ : state)
+        {
+            if (cold)
+            {
+                state.PauseTiming();
+                input.Evict();
+                state.ResumeTiming();
+            }
+            auto data = read(input.GetPath());
+            benchmark::DoNotOptimize(data.data());
+        }
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+    }
+
+    /// @brief Byte by byte through the stream buffer, as jars used to be read
+    void StreamIterator(benchmark::State& state, bool cold)
+    {
+        ReadFile(state, cold,
+            [](const fs::path& path)
+            {
+                std::vector<Byte> data;
+                InputBinaryFile jar(path, std::ios::binary);
+                data.reserve(fs::file_size(path));
+                std::copy(std::istreambuf_iterator(jar), std::istreambuf_iterator<Byte>(), std::back_inserter(data));
+                return data;
+            });
+    }
+
+    void Reader(benchmark::State& state, bool cold)
+    {
+        ReadFile(state, cold,
+            [](const fs::path& path)
+            {
+                return FileReader(path).ReadAll();
+            });
+    }
+
+    void Direct(benchmark::State& state, bool cold)
+    {
+        ReadFile(state, cold,
+            [](const fs::path& path)
+            {
+                return FileReader(path, ReadOptions(1)).ReadAll();
+            });
+    }
+
+    void FileSizes(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgName("size");
+        for (const int64_t size : {64 << 10, 1 << 20, 16 << 20, 128 << 20})
+        {
+            benchmark->Arg(size);
+        }
+    }
+}
+
+BENCHMARK_CAPTURE(StreamIterator, Warm, false)->Apply(FileSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Reader, Warm, false)->Apply(FileSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(StreamIterator, Cold, true)->Apply(FileSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Reader, Cold, true)->Apply(FileSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(Direct, Cold, true)->Apply(FileSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
\ No newline at end of file
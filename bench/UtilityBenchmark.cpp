@@ -0,0 +1,183 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <array>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <Utility.hpp>
+
+using namespace MCPacker;
+using namespace MCPacker::Utility::Definitions;
+
+namespace
+{
+    /// @brief Names of jars as they are found in real mods directories
+    const std::vector<std::string> ModNames = {
+        "fabric-api-0.92.2+1.20.1.jar",
+        "sodium-fabric-mc1.20.1-0.5.3.jar",
+        "lithium-fabric-mc1.20.1-0.11.2.jar",
+        "iris-mc1.20.1-1.6.11.jar",
+        "jei-1.20.1-forge-15.2.0.27.jar",
+        "create-1.20.1-0.5.1.f.jar",
+        "appliedenergistics2-forge-15.0.15.jar",
+        "journeymap-1.20.1-5.9.18-fabric.jar",
+        "ModernFix-forge-5.12.1+mc1.20.1.jar",
+        "architectury-9.1.12-forge.jar",
+        "cloth-config-11.1.106-fabric.jar",
+        "YungsBetterDungeons-1.20-Forge-4.0.3.jar",
+        "ferritecore-6.0.1-forge.jar",
+        "Xaeros_Minimap_23.9.7_Forge_1.20.jar",
+        "Пещеры-и-скалы-1.2.0.jar",
+        "更多物品-mod-1.20.1-2.4.jar"
+    };
+
+    std::vector<std::u32string> ModNamesInUTF32()
+    {
+        std::vector<std::u32string> names;
+        for (const auto& name : ModNames)
+        {
+            names.push_back(utf8::utf8to32(name));
+        }
+        return names;
+    }
+
+    /// @brief Names the way legacy packs store them, zero-padded to `PackIndex::NameLength` characters
+    std::vector<std::array<Byte, 255 * sizeof(char32_t)>> PaddedModNames()
+    {
+        std::vector<std::array<Byte, 255 * sizeof(char32_t)>> names;
+        for (const auto& name : ModNames)
+        {
+            names.push_back(Utility::ToUTF8Array<255>(std::string_view(name)));
+        }
+        return names;
+    }
+
+    void ValidateBaseline(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto& name : ModNames)
+            {
+                benchmark::DoNotOptimize(utf8::is_valid(std::begin(name), std::end(name)));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ModNames.size()));
+    }
+
+    void Validate(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto& name : ModNames)
+            {
+                benchmark::DoNotOptimize(Utility::IsValidUTF8(name));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ModNames.size()));
+    }
+
+    void ToUTF32Baseline(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto& name : ModNames)
+            {
+                benchmark::DoNotOptimize(utf8::utf8to32(name));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ModNames.size()));
+    }
+
+    void ToUTF32(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            for (const auto& name : ModNames)
+            {
+                benchmark::DoNotOptimize(Utility::UTF8ToUTF32(name));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ModNames.size()));
+    }
+
+    void ToUTF8Baseline(benchmark::State& state)
+    {
+        const auto names = ModNamesInUTF32();
+        for (auto _ : state)
+        {
+            for (const auto& name : names)
+            {
+                benchmark::DoNotOptimize(utf8::utf32to8(name));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+    }
+
+    void ToUTF8(benchmark::State& state)
+    {
+        const auto names = ModNamesInUTF32();
+        for (auto _ : state)
+        {
+            for (const auto& name : names)
+            {
+                benchmark::DoNotOptimize(Utility::UTF32ToUTF8(name));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+    }
+
+    /// @brief What reading a name of a legacy pack's record cost before the vectorised routines
+    void PaddedToStringBaseline(benchmark::State& state)
+    {
+        const auto names = PaddedModNames();
+        for (auto _ : state)
+        {
+            for (const auto& name : names)
+            {
+                const auto end = std::ranges::find_if(name, Utility::EqualsZero<Byte>());
+                if (utf8::is_valid(std::begin(name), end))
+                {
+                    benchmark::DoNotOptimize(std::string(std::begin(name), end));
+                }
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+    }
+
+    void PaddedToString(benchmark::State& state)
+    {
+        const auto names = PaddedModNames();
+        for (auto _ : state)
+        {
+            for (const auto& name : names)
+            {
+                benchmark::DoNotOptimize(Utility::UTF8ArrayToString(name));
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+    }
+}
+
+BENCHMARK(ValidateBaseline);
+BENCHMARK(Validate);
+BENCHMARK(ToUTF32Baseline);
+BENCHMARK(ToUTF32);
+BENCHMARK(ToUTF8Baseline);
+BENCHMARK(ToUTF8);
+BENCHMARK(PaddedToStringBaseline);
+BENCHMARK(PaddedToString);
\ No newline at end of file
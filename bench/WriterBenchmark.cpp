@@ -0,0 +1,127 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#include <core/BufferedWriter.hpp>
+
+using namespace MCPacker;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    /// @brief Amount of data written per iteration, split into records of the benchmark's argument size
+    constexpr size_t TotalSize = 64 << 20;
+
+    /// @brief Every record is a small header followed by its payload, like a mod's entry followed by its data
+    constexpr size_t HeaderSize = 16;
+
+    fs::path GetOutputPath()
+    {
+        const char* directory = std::getenv("MCPACKER_BENCH_DIR");
+        return (directory != nullptr ? fs::path(directory) : fs::temp_directory_path())
+            / ("mcpacker-writer-" + std::to_string(getpid()) + ".bin");
+    }
+
+    /// @brief Call `write(header, payload)` for every record of one iteration
+    template<typename Write>
+    void WriteRecords(benchmark::State& state, Write write)
+    {
+        const auto payloadSize = static_cast<size_t>(state.range(0));
+        const std::vector<Byte> header(HeaderSize, Byte(1));
+        const std::vector<Byte> payload(payloadSize, Byte(2));
+        const auto recordCount = std::max<size_t>(1, TotalSize / (HeaderSize + payloadSize));
+        for (size_t i = 0; i < recordCount; ++i)
+        {
+            write(std::span<const Byte>(header), std::span<const Byte>(payload));
+        }
+        state.SetBytesProcessed(state.bytes_processed() + static_cast<int64_t>(recordCount * (HeaderSize + payloadSize)));
+    }
+
+    /// @brief Byte by byte through the stream buffer, as `std::ranges::copy` into `std::ostreambuf_iterator` does
+    void StreamIterator(benchmark::State& state)
+    {
+        const auto path = GetOutputPath();
+        for (auto _ : state)
+        {
+            OutputBinaryFile file(path, std::ios::binary | std::ios::trunc);
+            WriteRecords(state,
+                [&file](std::span<const Byte> header, std::span<const Byte> payload)
+                {
+                    std::ranges::copy(header, std::ostreambuf_iterator(file));
+                    std::ranges::copy(payload, std::ostreambuf_iterator(file));
+                });
+            file.close();
+        }
+        fs::remove(path);
+    }
+
+    void StreamWrite(benchmark::State& state)
+    {
+        const auto path = GetOutputPath();
+        for (auto _ : state)
+        {
+            OutputBinaryFile file(path, std::ios::binary | std::ios::trunc);
+            WriteRecords(state,
+                [&file](std::span<const Byte> header, std::span<const Byte> payload)
+                {
+                    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+                    file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+                });
+            file.close();
+        }
+        fs::remove(path);
+    }
+
+    void Buffered(benchmark::State& state)
+    {
+        const auto path = GetOutputPath();
+        for (auto _ : state)
+        {
+            BufferedWriter file(path);
+            WriteRecords(state,
+                [&file](std::span<const Byte> header, std::span<const Byte> payload)
+                {
+                    file.Write(header);
+                    file.Write(payload);
+                });
+            file.Close();
+        }
+        fs::remove(path);
+    }
+
+    void RecordSizes(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgName("payload");
+        for (const int64_t size : {256, 4 << 10, 64 << 10, 1 << 20, 8 << 20})
+        {
+            benchmark->Arg(size);
+        }
+    }
+}
+
+BENCHMARK(StreamIterator)->Apply(RecordSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(StreamWrite)->Apply(RecordSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(Buffered)->Apply(RecordSizes)->Unit(benchmark::kMillisecond)->UseRealTime();
\ No newline at end of file
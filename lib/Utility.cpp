@@ -0,0 +1,394 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <string_view>
+#include "Utility.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MCPACKER_X86 1
+#endif
+
+using namespace MCPacker::Utility::Definitions;
+using MCPacker::Utility::SIMDLevel;
+
+namespace
+{
+    /// @brief Routines the text functions are built from, one set per instruction set.
+    /// Each of them handles the longest prefix of its input it can and returns its length
+    struct Kernels
+    {
+        SIMDLevel level;
+
+        /// @brief Length of the run of ASCII characters `data` starts with
+        size_t (*asciiPrefix)(const Byte* data, size_t size);
+        size_t (*findZero)(const Byte* data, size_t size);
+        size_t (*findZero32)(const char32_t* data, size_t size);
+
+        /// @brief Widen the run of ASCII characters `data` starts with into `output`
+        size_t (*widenASCII)(const Byte* data, size_t size, char32_t* output);
+
+        /// @brief Narrow the run of ASCII characters `data` starts with into `output`
+        size_t (*narrowASCII)(const char32_t* data, size_t size, Byte* output);
+    };
+
+    bool IsASCII(Byte character)
+    {
+        return static_cast<unsigned char>(character) < 0x80;
+    }
+
+    size_t ASCIIPrefixScalar(const Byte* data, size_t size)
+    {
+        return static_cast<size_t>(std::find_if_not(data, data + size, IsASCII) - data);
+    }
+
+    template<typename T>
+    size_t FindZeroScalar(const T* data, size_t size)
+    {
+        return static_cast<size_t>(std::find(data, data + size, T(0)) - data);
+    }
+
+    size_t WidenASCIIScalar(const Byte* data, size_t size, char32_t* output)
+    {
+        size_t i = 0;
+        for (; i < size and IsASCII(data[i]); ++i)
+        {
+            output[i] = static_cast<char32_t>(data[i]);
+        }
+        return i;
+    }
+
+    size_t NarrowASCIIScalar(const char32_t* data, size_t size, Byte* output)
+    {
+        size_t i = 0;
+        for (; i < size and data[i] < 0x80; ++i)
+        {
+            output[i] = static_cast<Byte>(data[i]);
+        }
+        return i;
+    }
+
+#ifdef MCPACKER_X86
+    // Vectorised kernels process whole vectors and leave the tail, or the vector with the first character
+    // they cannot handle, to the next narrower kernel. AVX2 ones clear upper halves of the registers before
+    // leaving, otherwise SSE code running after them pays for a state transition on every instruction
+
+    __attribute__((target("sse2")))
+    size_t ASCIIPrefixSSE2(const Byte* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            const auto mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+            if (mask != 0)
+            {
+                return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+            }
+        }
+        return i + ASCIIPrefixScalar(data + i, size - i);
+    }
+
+    __attribute__((target("sse2")))
+    size_t FindZeroSSE2(const Byte* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_setzero_si128()));
+            if (mask != 0)
+            {
+                return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+            }
+        }
+        return i + FindZeroScalar(data + i, size - i);
+    }
+
+    __attribute__((target("sse2")))
+    size_t FindZero32SSE2(const char32_t* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4)
+        {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const auto mask = _mm_movemask_epi8(_mm_cmpeq_epi32(chunk, _mm_setzero_si128()));
+            if (mask != 0)
+            {
+                return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask))) / sizeof(char32_t);
+            }
+        }
+        return i + FindZeroScalar(data + i, size - i);
+    }
+
+    __attribute__((target("sse2")))
+    size_t WidenASCIISSE2(const Byte* data, size_t size, char32_t* output)
+    {
+        const auto zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            if (_mm_movemask_epi8(chunk) != 0)
+            {
+                break;
+            }
+            const auto low = _mm_unpacklo_epi8(chunk, zero);
+            const auto high = _mm_unpackhi_epi8(chunk, zero);
+            auto* destination = reinterpret_cast<__m128i*>(output + i);
+            _mm_storeu_si128(destination, _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(destination + 1, _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(destination + 2, _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(destination + 3, _mm_unpackhi_epi16(high, zero));
+        }
+        return i + WidenASCIIScalar(data + i, size - i, output + i);
+    }
+
+    __attribute__((target("sse2")))
+    size_t NarrowASCIISSE2(const char32_t* data, size_t size, Byte* output)
+    {
+        const auto nonASCII = _mm_set1_epi32(~0x7f);
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            const auto* source = reinterpret_cast<const __m128i*>(data + i);
+            const auto first = _mm_loadu_si128(source), second = _mm_loadu_si128(source + 1);
+            const auto third = _mm_loadu_si128(source + 2), fourth = _mm_loadu_si128(source + 3);
+            const auto all = _mm_or_si128(_mm_or_si128(first, second), _mm_or_si128(third, fourth));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(all, nonASCII), _mm_setzero_si128())) != 0xffff)
+            {
+                break;
+            }
+            // Every value is below 0x80, so saturation never kicks in
+            const auto narrowed = _mm_packus_epi16(_mm_packs_epi32(first, second), _mm_packs_epi32(third, fourth));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), narrowed);
+        }
+        return i + NarrowASCIIScalar(data + i, size - i, output + i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t ASCIIPrefixAVX2(const Byte* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            const auto mask = _mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+            if (mask != 0)
+            {
+                _mm256_zeroupper();
+                return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+            }
+        }
+        _mm256_zeroupper();
+        return i + ASCIIPrefixSSE2(data + i, size - i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t FindZeroAVX2(const Byte* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            const auto mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_setzero_si256()));
+            if (mask != 0)
+            {
+                _mm256_zeroupper();
+                return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask)));
+            }
+        }
+        _mm256_zeroupper();
+        return i + FindZeroSSE2(data + i, size - i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t FindZero32AVX2(const char32_t* data, size_t size)
+    {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            const auto mask = _mm256_movemask_epi8(_mm256_cmpeq_epi32(chunk, _mm256_setzero_si256()));
+            if (mask != 0)
+            {
+                _mm256_zeroupper();
+                return i + static_cast<size_t>(std::countr_zero(static_cast<unsigned>(mask))) / sizeof(char32_t);
+            }
+        }
+        _mm256_zeroupper();
+        return i + FindZero32SSE2(data + i, size - i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t WidenASCIIAVX2(const Byte* data, size_t size, char32_t* output)
+    {
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            if (_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i))) != 0)
+            {
+                break;
+            }
+            for (size_t part = 0; part < 32; part += 8)
+            {
+                const auto chunk = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i + part));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i + part), _mm256_cvtepu8_epi32(chunk));
+            }
+        }
+        _mm256_zeroupper();
+        return i + WidenASCIISSE2(data + i, size - i, output + i);
+    }
+
+    __attribute__((target("avx2")))
+    size_t NarrowASCIIAVX2(const char32_t* data, size_t size, Byte* output)
+    {
+        const auto nonASCII = _mm256_set1_epi32(~0x7f);
+        // Packing works within 128-bit lanes, this puts the resulting groups of four characters back in order
+        const auto order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            const auto* source = reinterpret_cast<const __m256i*>(data + i);
+            const auto first = _mm256_loadu_si256(source), second = _mm256_loadu_si256(source + 1);
+            const auto third = _mm256_loadu_si256(source + 2), fourth = _mm256_loadu_si256(source + 3);
+            const auto all = _mm256_or_si256(_mm256_or_si256(first, second), _mm256_or_si256(third, fourth));
+            if (not _mm256_testz_si256(all, nonASCII))
+            {
+                break;
+            }
+            const auto packed = _mm256_packus_epi16(_mm256_packs_epi32(first, second), _mm256_packs_epi32(third, fourth));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_permutevar8x32_epi32(packed, order));
+        }
+        _mm256_zeroupper();
+        return i + NarrowASCIISSE2(data + i, size - i, output + i);
+    }
+#endif
+
+    /// @brief Pick the kernels of the widest instruction set the CPU supports.
+    /// `MCPACKER_SIMD` set to `scalar` or `sse2` caps it, which is handy for benchmarks and debugging
+    Kernels SelectKernels()
+    {
+        const Kernels scalar{SIMDLevel::Scalar, ASCIIPrefixScalar, FindZeroScalar<Byte>, FindZeroScalar<char32_t>,
+            WidenASCIIScalar, NarrowASCIIScalar};
+
+        const char* cap = std::getenv("MCPACKER_SIMD");
+        const std::string_view limit = cap != nullptr ? cap : "";
+        if (limit == "scalar")
+        {
+            return scalar;
+        }
+
+#ifdef MCPACKER_X86
+        __builtin_cpu_init();
+        if (limit != "sse2" and __builtin_cpu_supports("avx2"))
+        {
+            return {SIMDLevel::AVX2, ASCIIPrefixAVX2, FindZeroAVX2, FindZero32AVX2, WidenASCIIAVX2, NarrowASCIIAVX2};
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return {SIMDLevel::SSE2, ASCIIPrefixSSE2, FindZeroSSE2, FindZero32SSE2, WidenASCIISSE2, NarrowASCIISSE2};
+        }
+#endif
+        return scalar;
+    }
+
+    const Kernels& GetKernels()
+    {
+        static const Kernels kernels = SelectKernels();
+        return kernels;
+    }
+}
+
+SIMDLevel MCPacker::Utility::GetSIMDLevel()
+{
+    return GetKernels().level;
+}
+
+size_t MCPacker::Utility::FindZero(const Byte* data, size_t size)
+{
+    return GetKernels().findZero(data, size);
+}
+
+size_t MCPacker::Utility::FindZero(const char32_t* data, size_t size)
+{
+    return GetKernels().findZero32(data, size);
+}
+
+bool MCPacker::Utility::IsValidUTF8(std::string_view utf8str)
+{
+    const auto& kernels = GetKernels();
+    auto current = utf8str.data();
+    const auto end = current + utf8str.size();
+    while (true)
+    {
+        current += kernels.asciiPrefix(current, static_cast<size_t>(end - current));
+        if (current == end)
+        {
+            return true;
+        }
+        // Multibyte sequences are rare in names, they are checked one at a time until ASCII resumes
+        if (utf8::internal::validate_next(current, end) != utf8::internal::UTF8_OK)
+        {
+            return false;
+        }
+    }
+}
+
+std::u32string MCPacker::Utility::UTF8ToUTF32(std::string_view utf8str)
+{
+    const auto& kernels = GetKernels();
+    // No character takes less than a byte, so the result never outgrows the input
+    std::u32string utf32str(utf8str.size(), U'\0');
+    auto input = utf8str.data();
+    const auto end = input + utf8str.size();
+    auto output = utf32str.data();
+    while (input != end)
+    {
+        const auto run = kernels.widenASCII(input, static_cast<size_t>(end - input), output);
+        input += run;
+        output += run;
+        if (input != end)
+        {
+            *output++ = utf8::next(input, end);
+        }
+    }
+    utf32str.resize(static_cast<size_t>(output - utf32str.data()));
+    return utf32str;
+}
+
+std::string MCPacker::Utility::UTF32ToUTF8(std::u32string_view utf32str)
+{
+    const auto& kernels = GetKernels();
+    std::string utf8str(utf32str.size() * 4, '\0');
+    auto input = utf32str.data();
+    const auto end = input + utf32str.size();
+    auto output = utf8str.data();
+    while (input != end)
+    {
+        const auto run = kernels.narrowASCII(input, static_cast<size_t>(end - input), output);
+        input += run;
+        output += run;
+        if (input != end)
+        {
+            output = utf8::append(*input++, output);
+        }
+    }
+    utf8str.resize(static_cast<size_t>(output - utf8str.data()));
+    return utf8str;
+}
\ No newline at end of file
@@ -24,7 +24,9 @@
 #include <cstdint>
 #include <concepts>
 #include <ranges>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <boost/endian.hpp>
 #include "utfcpp-4.0.5/utf8.h"
 
@@ -41,7 +43,10 @@ namespace MCPacker
             Full,
             /// @brief Read only meta information of the pack to avoid allocation
             /// of potentially a lot of memory
-            OnlyMetaInfo
+            OnlyMetaInfo,
+            /// @brief Read meta information of the pack and map the file into memory,
+            /// so mods' data is viewed in place instead of being copied
+            Mapped
         };
 
         namespace Definitions
@@ -76,6 +81,35 @@ namespace MCPacker
         };
 
 
+        /// @brief Instruction set the text routines below are vectorised with
+        enum class SIMDLevel
+        {
+            Scalar,
+            SSE2,
+            AVX2
+        };
+
+        /// @brief Instruction set picked for the text routines, the widest one the CPU supports
+        SIMDLevel GetSIMDLevel();
+
+        /// @brief Position of the first zero in `data` or `size` if there is none
+        size_t FindZero(const Definitions::Byte* data, size_t size);
+        size_t FindZero(const char32_t* data, size_t size);
+
+        /// @brief Check whether `utf8str` is valid UTF-8
+        /// @details Runs of ASCII characters are checked a vector at a time
+        bool IsValidUTF8(std::string_view utf8str);
+
+        /// @brief Converts UTF-8 encoded string to UTF-32
+        /// @details Runs of ASCII characters are widened a vector at a time
+        /// @throws utf8::exception if the string is not valid UTF-8
+        std::u32string UTF8ToUTF32(std::string_view utf8str);
+
+        /// @brief Converts UTF-32 encoded string to UTF-8
+        /// @details Runs of ASCII characters are narrowed a vector at a time
+        /// @throws utf8::exception if the string contains an invalid code point
+        std::string UTF32ToUTF8(std::u32string_view utf32str);
+
         /// @brief Converts integral to a byte array with big-endian encoding
         /// @tparam T 
         /// @param n Number to convert
@@ -109,42 +143,71 @@ namespace MCPacker
         }
 
         
-        /// @brief Converts UTF-32 encoded string into array of bytes in UTF-8 encoding
-        /// @tparam N number of characters in `str`
-        /// @param str string to converto into byte array
-        /// @return UTF-8 encoded byte array
-        template<size_t N>
-        std::array<Definitions::Byte, N * sizeof(char32_t)> ToUTF8Array(std::u32string_view str)
-        {
-            std::array<Definitions::Byte, N * sizeof(char32_t)> utf8str;
-            utf8str.fill(0);
-            utf8::utf32to8(std::begin(str), std::end(str), std::begin(utf8str));
-            return utf8str;
-        }
-
         /// @brief Converts UTF-8 encoded byte array to UTF-32 encoded array
         /// @tparam N number of bytes in `utf8str`
         /// @param utf8str UTF-8 encoded byte array
         /// @return array of UTF-32 characters
         /// @warning `N` must be divisible by 4, i.e. `sizeof(char32_t)`
+        /// @throws std::invalid_argument if there are more characters than fit into the result
         template<size_t N>
         requires(N % sizeof(char32_t) == 0)
         std::array<char32_t, N / sizeof(char32_t)> FromUTF8Array(const std::array<Definitions::Byte, N>& utf8str)
         {
             std::array<char32_t, N / sizeof(char32_t)> utf32str;
+            const auto converted = UTF8ToUTF32(std::string_view(utf8str.data(), FindZero(utf8str.data(), utf8str.size())));
+            if (converted.size() > utf32str.size())
+            {
+                throw std::invalid_argument("String is too long!");
+            }
             utf32str.fill(0);
-            auto end = std::ranges::find_if(utf8str, EqualsZero<Definitions::Byte>());
-            utf8::utf8to32(std::begin(utf8str), end, std::begin(utf32str));
+            std::ranges::copy(converted, std::begin(utf32str));
             return utf32str;
         }
 
+        /// @brief Copies UTF-8 encoded string into a zero-padded byte array
+        /// @tparam N number of characters the array has room for in the worst case
+        /// @throws std::invalid_argument if the string does not fit
+        template<size_t N>
+        std::array<Definitions::Byte, N * sizeof(char32_t)> ToUTF8Array(std::string_view utf8str)
+        {
+            std::array<Definitions::Byte, N * sizeof(char32_t)> bytes;
+            if (utf8str.size() > bytes.size())
+            {
+                throw std::invalid_argument("String is too long!");
+            }
+            bytes.fill(0);
+            std::ranges::copy(utf8str, std::begin(bytes));
+            return bytes;
+        }
+
+        /// @brief Converts UTF-32 encoded string into array of bytes in UTF-8 encoding
+        /// @tparam N number of characters in `str`
+        /// @param str string to converto into byte array
+        /// @return UTF-8 encoded byte array
+        /// @throws std::invalid_argument if the string does not fit
+        template<size_t N>
+        std::array<Definitions::Byte, N * sizeof(char32_t)> ToUTF8Array(std::u32string_view str)
+        {
+            return ToUTF8Array<N>(std::string_view(UTF32ToUTF8(str)));
+        }
+
+        /// @brief Converts zero-padded UTF-8 encoded byte array to a string
+        /// @throws std::invalid_argument if the array is not valid UTF-8
+        template<size_t N>
+        std::string UTF8ArrayToString(const std::array<Definitions::Byte, N>& utf8str)
+        {
+            const std::string_view value(utf8str.data(), FindZero(utf8str.data(), utf8str.size()));
+            if (not IsValidUTF8(value))
+            {
+                throw std::invalid_argument("String is not valid UTF-8!");
+            }
+            return std::string(value);
+        }
+
         template<size_t N>
         std::string UTF32ArrayToUTF8String(const std::array<char32_t, N>& utf32array)
         {
-            std::string utf8str;
-            const auto end = std::ranges::find_if(utf32array, EqualsZero<char32_t>());
-            utf8::utf32to8(std::begin(utf32array), end, std::back_inserter(utf8str));
-            return utf8str;
+            return UTF32ToUTF8(std::u32string_view(utf32array.data(), FindZero(utf32array.data(), utf32array.size())));
         }
     }
 }
@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/format.hpp>
+#include <core/DependencyResolver.hpp>
+#include <core/ModPack.hpp>
+#include <core/PackBuilder.hpp>
+#include <core/PackCache.hpp>
+#include <core/ParallelFor.hpp>
+
+using boost::format;
+using namespace MCPacker;
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr std::string_view Usage =
+R"(usage: mcpacker-cli <command> [options] <arguments>
+
+commands:
+  create [--description TEXT] [--output DIR] [--zstd[=LEVEL]] [--blobs] [--workers N] NAME JAR|DIR...
+      Write pack NAME.pck from jars, directories contribute every jar directly inside them.
+      With --blobs mods are put into the `blobs` store next to the pack and only referenced,
+      otherwise --zstd mods are compressed by N threads, one per hardware thread by default.
+      DIR is created if it does not exist
+  list [DIR]
+      List the packs in DIR, `packs` by default
+  inspect PACK
+      Show the pack's metadata, its mods and problems with their dependencies
+  verify [--workers N] PACK...
+      Check every mod of the packs against its checksum
+  deploy [--incremental] [--workers N] [--no-io-uring] PACK DIR
+      Write the pack's mods into DIR, batching the writes through io_uring where the kernel supports it
+)";
+
+    constexpr int ExitFailure = 1, ExitUsage = 2;
+
+    /// @brief Command line which does not match the command's usage
+    class UsageError : public std::invalid_argument
+    {
+    public:
+        using std::invalid_argument::invalid_argument;
+    };
+
+    /// @brief Arguments of a command split into options and positional arguments
+    /// @details Options are written as `--name`, `--name=value` or `--name value` for options which always take one,
+    /// everything after `--` is positional
+    class Arguments
+    {
+    private:
+        std::vector<std::string_view> positional;
+        std::map<std::string_view, std::string_view> options;
+
+    public:
+        /// @param flags Options taking no value or an optional `=value`
+        /// @param valued Options always taking a value
+        Arguments(std::span<char*> arguments, const std::set<std::string_view>& flags, const std::set<std::string_view>& valued)
+            :
+            positional(),
+            options()
+        {
+            bool onlyPositional = false;
+            for (size_t i = 0; i < arguments.size(); ++i)
+            {
+                const std::string_view argument = arguments[i];
+                if (onlyPositional or not argument.starts_with("--"))
+                {
+                    positional.push_back(argument);
+                    continue;
+                }
+                if (argument == "--")
+                {
+                    onlyPositional = true;
+                    continue;
+                }
+
+                const auto separator = argument.find('=');
+                const auto name = argument.substr(2, separator == std::string_view::npos ? std::string_view::npos : separator - 2);
+                if (valued.contains(name))
+                {
+                    if (separator != std::string_view::npos)
+                    {
+                        options[name] = argument.substr(separator + 1);
+                    }
+                    else if (i + 1 < arguments.size())
+                    {
+                        options[name] = arguments[++i];
+                    }
+                    else
+                    {
+                        throw UsageError((format("Option --%1% needs a value") % name).str());
+                    }
+                }
+                else if (flags.contains(name))
+                {
+                    options[name] = separator == std::string_view::npos ? std::string_view() : argument.substr(separator + 1);
+                }
+                else
+                {
+                    throw UsageError((format("Unknown option --%1%") % name).str());
+                }
+            }
+        }
+
+        const std::vector<std::string_view>& GetPositional() const
+        {
+            return positional;
+        }
+
+        bool Has(std::string_view name) const
+        {
+            return options.contains(name);
+        }
+
+        std::optional<std::string_view> Get(std::string_view name) const
+        {
+            const auto option = options.find(name);
+            if (option == std::end(options))
+            {
+                return std::nullopt;
+            }
+            return option->second;
+        }
+
+        /// @throws UsageError if the value is not a non-negative number
+        template<typename T>
+        T GetNumber(std::string_view name, T fallback) const
+        {
+            const auto value = Get(name);
+            if (not value.has_value() or value->empty())
+            {
+                return fallback;
+            }
+            T number;
+            const auto [end, error] = std::from_chars(value->data(), value->data() + value->size(), number);
+            if (error != std::errc() or end != value->data() + value->size())
+            {
+                throw UsageError((format("Option --%1% needs a number, not %2%") % name % *value).str());
+            }
+            return number;
+        }
+    };
+
+    /// @brief Store of mods referenced by packs in `directory`, at the same place `ModPackManager` keeps it
+    std::shared_ptr<const BlobStore> GetBlobStore(const fs::path& directory)
+    {
+        return std::make_shared<const BlobStore>(directory / "blobs");
+    }
+
+    ModPack ReadPack(const fs::path& packFile)
+    {
+        return ModPack(packFile, Utility::ReadingMode::OnlyMetaInfo, GetBlobStore(packFile.parent_path()));
+    }
+
+    std::string_view GetCodecName(Codec codec)
+    {
+        switch (codec)
+        {
+            case Codec::Store:
+                return "store";
+            case Codec::Zstd:
+                return "zstd";
+        }
+        return "unknown";
+    }
+
+    int Create(const Arguments& arguments)
+    {
+        const auto& positional = arguments.GetPositional();
+        if (positional.size() < 2)
+        {
+            throw UsageError("create needs a name and at least one jar");
+        }
+
+        std::optional<std::u32string> description;
+        if (const auto text = arguments.Get("description"))
+        {
+            description = Utility::UTF8ToUTF32(*text);
+        }
+        PackBuilder builder(Utility::UTF8ToUTF32(positional[0]), description);
+        for (const auto& argument : std::span(positional).subspan(1))
+        {
+            const fs::path path(argument);
+            if (not fs::is_directory(path))
+            {
+                builder.AddMod(path);
+                continue;
+            }
+
+            // Directory listings come in no particular order, but packs should not depend on it
+            std::vector<fs::path> jars;
+            for (const auto& entry : fs::directory_iterator(path))
+            {
+                if (entry.is_regular_file() and entry.path().extension() == ".jar")
+                {
+                    jars.push_back(entry.path());
+                }
+            }
+            std::ranges::sort(jars);
+            std::ranges::for_each(jars,
+                [&builder](const fs::path& jar)
+                {
+                    builder.AddMod(jar);
+                });
+        }
+
+        CompressionOptions compression;
+        compression.workers = arguments.GetNumber<unsigned>("workers", 0);
+        if (arguments.Has("zstd"))
+        {
+            compression.codec = Codec::Zstd;
+            compression.level = arguments.GetNumber<int>("zstd", 3);
+        }
+
+        const fs::path output(arguments.Get("output").value_or("."));
+        fs::create_directories(output);
+        const auto blobStore = arguments.Has("blobs") ? GetBlobStore(output) : nullptr;
+        std::cout << builder.WriteToFile(output, compression, blobStore.get()).string() << '\n';
+        return EXIT_SUCCESS;
+    }
+
+    /// @brief List packs the way `ModPackManager` discovers them, reusing and refreshing the directory's `PackCache`
+    int List(const Arguments& arguments)
+    {
+        const auto& positional = arguments.GetPositional();
+        if (positional.size() > 1)
+        {
+            throw UsageError("list takes at most one directory");
+        }
+        const fs::path directory(positional.empty() ? "packs" : positional[0]);
+
+        std::vector<fs::path> packFiles;
+        for (const auto& entry : fs::directory_iterator(directory))
+        {
+            if (entry.is_regular_file() and entry.path().extension().u32string() == ModPack::MetaInfo::PackExt)
+            {
+                packFiles.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(packFiles);
+
+        const auto blobStore = GetBlobStore(directory);
+        const auto cache = PackCache::Load(directory);
+        std::vector<std::optional<ModPack>> packs(packFiles.size());
+        std::vector<std::optional<PackCache::FileStatus>> statuses(packFiles.size());
+        std::vector<std::string> errors(packFiles.size());
+        std::vector<uint8_t> cached(packFiles.size(), false);
+        ParallelFor(packFiles.size(), 0,
+            [&](size_t i)
+            {
+                statuses[i] = PackCache::Stat(packFiles[i]);
+                if (statuses[i].has_value())
+                {
+                    packs[i] = cache.Find(packFiles[i], *statuses[i], blobStore);
+                }
+                cached[i] = packs[i].has_value();
+                if (not cached[i])
+                {
+                    try
+                    {
+                        packs[i].emplace(packFiles[i], Utility::ReadingMode::OnlyMetaInfo, blobStore);
+                    }
+                    catch (const std::exception& error)
+                    {
+                        errors[i] = error.what();
+                    }
+                }
+            });
+
+        PackCache updatedCache;
+        int status = EXIT_SUCCESS;
+        for (size_t i = 0; i < packFiles.size(); ++i)
+        {
+            if (not packs[i].has_value())
+            {
+                std::cerr << format("%1%: %2%\n") % packFiles[i].string() % errors[i];
+                status = ExitFailure;
+                continue;
+            }
+
+            const auto& index = packs[i]->GetIndex();
+            uint64_t size = 0;
+            for (size_t mod = 0; mod < index.GetSize(); ++mod)
+            {
+                size += index.At(mod).size;
+            }
+            std::cout << format("%1%\t%2% mods\t%3% bytes\t%4%\n") % packs[i]->GetMetaInfo().name % index.GetSize() % size
+                % packFiles[i].filename().string();
+            if (statuses[i].has_value())
+            {
+                updatedCache.Set(packFiles[i], *statuses[i], *packs[i]);
+            }
+        }
+
+        const auto hits = static_cast<size_t>(std::ranges::count(cached, true));
+        if (hits != packFiles.size() or hits != cache.GetSize())
+        {
+            try
+            {
+                updatedCache.Save(directory);
+            }
+            catch (const std::exception&)
+            {
+                // A cache which cannot be written only costs reading the packs on the next run
+            }
+        }
+        return status;
+    }
+
+    int Inspect(const Arguments& arguments)
+    {
+        const auto& positional = arguments.GetPositional();
+        if (positional.size() != 1)
+        {
+            throw UsageError("inspect needs exactly one pack");
+        }
+
+        const auto pack = ReadPack(positional[0]);
+        const auto& index = pack.GetIndex();
+        std::cout << format("name: %1%\ndescription: %2%\nformat version: %3%\nmods: %4%\n")
+            % pack.GetMetaInfo().name % pack.GetMetaInfo().description % index.GetVersion() % index.GetSize();
+
+        for (size_t mod = 0; mod < index.GetSize(); ++mod)
+        {
+            const auto& entry = index.At(mod);
+            std::cout << format("  %1%\t%2% bytes\t%3%") % entry.name % entry.size
+                % (entry.blob.has_value() ? std::string_view("blob") : GetCodecName(entry.codec));
+            if (entry.manifest.has_value())
+            {
+                std::cout << format("\t%1% %2% (%3%)") % entry.manifest->id % entry.manifest->version
+                    % ModManifest::GetLoaderName(entry.manifest->loader);
+            }
+            std::cout << '\n';
+        }
+
+        const auto resolver = pack.ResolveDependencies();
+        for (const auto& problem : resolver.GetProblems())
+        {
+            std::cout << "problem: " << resolver.Describe(problem) << '\n';
+        }
+        return resolver.GetProblems().empty() ? EXIT_SUCCESS : ExitFailure;
+    }
+
+    int Verify(const Arguments& arguments)
+    {
+        const auto& positional = arguments.GetPositional();
+        if (positional.empty())
+        {
+            throw UsageError("verify needs at least one pack");
+        }
+
+        const auto workers = arguments.GetNumber<unsigned>("workers", 0);
+        int status = EXIT_SUCCESS;
+        for (const auto& packFile : positional)
+        {
+            try
+            {
+                const auto damaged = ReadPack(packFile).Verify(workers);
+                for (const auto& mod : damaged)
+                {
+                    std::cout << format("%1%: %2% is damaged\n") % packFile % Utility::UTF32ToUTF8(mod);
+                }
+                if (damaged.empty())
+                {
+                    std::cout << format("%1%: ok\n") % packFile;
+                }
+                else
+                {
+                    status = ExitFailure;
+                }
+            }
+            catch (const std::exception& error)
+            {
+                std::cerr << format("%1%: %2%\n") % packFile % error.what();
+                status = ExitFailure;
+            }
+        }
+        return status;
+    }
+
+    int Deploy(const Arguments& arguments)
+    {
+        const auto& positional = arguments.GetPositional();
+        if (positional.size() != 2)
+        {
+            throw UsageError("deploy needs a pack and a directory");
+        }
+
+        ModPack::DeployOptions options;
+        options.incremental = arguments.Has("incremental");
+        options.workers = arguments.GetNumber<unsigned>("workers", 0);
+        options.ioRing = not arguments.Has("no-io-uring");
+        const auto report = ReadPack(positional[0]).Deploy(positional[1], options);
+
+        uint64_t written = 0;
+        for (const auto& file : report.files)
+        {
+            written += file.size;
+        }
+        const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(report.duration).count();
+        std::cout << format("%1% mods written (%2% bytes), %3% unchanged, %4% removed in %5% ms\n")
+            % report.files.size() % written % report.unchanged.size() % report.removed.size() % milliseconds;
+        return EXIT_SUCCESS;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::span<char*> arguments(argv, static_cast<size_t>(argc));
+    if (arguments.size() < 2)
+    {
+        std::cerr << Usage;
+        return ExitUsage;
+    }
+
+    const std::string_view command = arguments[1];
+    const auto commandArguments = arguments.subspan(2);
+    try
+    {
+        if (command == "create")
+        {
+            return Create(Arguments(commandArguments, {"zstd", "blobs"}, {"description", "output", "workers"}));
+        }
+        if (command == "list")
+        {
+            return List(Arguments(commandArguments, {}, {}));
+        }
+        if (command == "inspect")
+        {
+            return Inspect(Arguments(commandArguments, {}, {}));
+        }
+        if (command == "verify")
+        {
+            return Verify(Arguments(commandArguments, {}, {"workers"}));
+        }
+        if (command == "deploy")
+        {
+            return Deploy(Arguments(commandArguments, {"incremental", "no-io-uring"}, {"workers"}));
+        }
+        if (command == "help" or command == "--help" or command == "-h")
+        {
+            std::cout << Usage;
+            return EXIT_SUCCESS;
+        }
+        throw UsageError((format("Unknown command %1%") % command).str());
+    }
+    catch (const UsageError& error)
+    {
+        std::cerr << "mcpacker-cli: " << error.what() << "\nRun `mcpacker-cli help` to see the usage\n";
+        return ExitUsage;
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "mcpacker-cli: " << error.what() << '\n';
+        return ExitFailure;
+    }
+}
\ No newline at end of file
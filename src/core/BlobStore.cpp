@@ -0,0 +1,261 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <openssl/evp.h>
+#include <boost/format.hpp>
+#include "BlobStore.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr std::string_view HexDigits = "0123456789abcdef";
+
+    EVP_MD_CTX* CreateContext()
+    {
+        EVP_MD_CTX* context = EVP_MD_CTX_new();
+        if (context == nullptr or EVP_DigestInit_ex(context, EVP_sha256(), nullptr) != 1)
+        {
+            EVP_MD_CTX_free(context);
+            throw std::runtime_error("Unable to initialise SHA-256!");
+        }
+        return context;
+    }
+
+    MCPacker::BlobStore::Digest Finish(EVP_MD_CTX* context)
+    {
+        MCPacker::BlobStore::Digest digest;
+        if (EVP_DigestFinal_ex(context, digest.data(), nullptr) != 1)
+        {
+            throw std::runtime_error("Unable to compute SHA-256!");
+        }
+        return digest;
+    }
+
+    /// @brief Unique name for a temporary file, unique across threads and processes sharing the store
+    fs::path MakeTemporaryName()
+    {
+        static std::atomic<uint64_t> counter = 0;
+        const auto thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+        return (format("tmp-%1%-%2%-%3%") % getpid() % thread % counter++).str();
+    }
+}
+
+MCPacker::BlobStore::Writer::Writer(const BlobStore& store)
+    :
+    store(store),
+    temporaryPath(store.root / MakeTemporaryName()),
+    file(),
+    context(nullptr),
+    committed(false)
+{
+    fs::create_directories(store.root);
+    file.open(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (not file.is_open())
+    {
+        const auto message = format("Unable to create file %1%!") % std::quoted(temporaryPath.string());
+        throw std::runtime_error(message.str());
+    }
+    context = CreateContext();
+}
+
+MCPacker::BlobStore::Writer::~Writer()
+{
+    EVP_MD_CTX_free(context);
+    if (not committed)
+    {
+        file.close();
+        std::error_code ignored;
+        fs::remove(temporaryPath, ignored);
+    }
+}
+
+void MCPacker::BlobStore::Writer::Write(std::span<const Byte> data)
+{
+    EVP_DigestUpdate(context, data.data(), data.size());
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+MCPacker::BlobStore::Digest MCPacker::BlobStore::Writer::Commit()
+{
+    const auto digest = Finish(context);
+    file.close();
+    if (not file)
+    {
+        const auto message = format("Unable to write file %1%!") % std::quoted(temporaryPath.string());
+        throw std::runtime_error(message.str());
+    }
+
+    const auto path = store.GetPath(digest);
+    if (fs::exists(path))
+    {
+        fs::remove(temporaryPath);
+    }
+    else
+    {
+        fs::create_directories(path.parent_path());
+        fs::rename(temporaryPath, path);
+    }
+
+    committed = true;
+    return digest;
+}
+
+MCPacker::BlobStore::Lock::Lock(const BlobStore& store, Mode mode)
+    :
+    fd(-1)
+{
+    const auto path = store.root / "lock";
+    fs::create_directories(store.root);
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+        const auto message = format("Unable to open file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+
+    while (flock(fd, mode == Mode::Exclusive ? LOCK_EX : LOCK_SH) == -1)
+    {
+        if (errno != EINTR)
+        {
+            const auto message = format("Unable to lock file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+            close(fd);
+            throw std::runtime_error(message.str());
+        }
+    }
+}
+
+MCPacker::BlobStore::Lock::~Lock()
+{
+    // Closing the file releases the lock
+    close(fd);
+}
+
+MCPacker::BlobStore::BlobStore(fs::path root)
+    :
+    root(std::move(root))
+{
+
+}
+
+MCPacker::BlobStore::Digest MCPacker::BlobStore::Hash(std::span<const Byte> data)
+{
+    EVP_MD_CTX* context = CreateContext();
+    EVP_DigestUpdate(context, data.data(), data.size());
+    const auto digest = Finish(context);
+    EVP_MD_CTX_free(context);
+    return digest;
+}
+
+std::string MCPacker::BlobStore::ToHex(const Digest& digest)
+{
+    std::string hex;
+    hex.reserve(2 * digest.size());
+    for (const auto byte : digest)
+    {
+        hex.push_back(HexDigits[byte >> 4]);
+        hex.push_back(HexDigits[byte & 0xf]);
+    }
+    return hex;
+}
+
+std::optional<MCPacker::BlobStore::Digest> MCPacker::BlobStore::FromHex(std::string_view hex)
+{
+    Digest digest;
+    if (hex.size() != 2 * digest.size())
+    {
+        return std::nullopt;
+    }
+
+    for (size_t i = 0; i < digest.size(); ++i)
+    {
+        const auto high = HexDigits.find(hex[2 * i]), low = HexDigits.find(hex[2 * i + 1]);
+        if (high == std::string_view::npos or low == std::string_view::npos)
+        {
+            return std::nullopt;
+        }
+        digest[i] = static_cast<uint8_t>(high << 4 | low);
+    }
+    return digest;
+}
+
+MCPacker::BlobStore::Digest MCPacker::BlobStore::Put(std::span<const Byte> data) const
+{
+    // Hashing first spares writing data the store already has
+    const auto digest = Hash(data);
+    if (not Contains(digest))
+    {
+        Writer writer(*this);
+        writer.Write(data);
+        writer.Commit();
+    }
+    return digest;
+}
+
+fs::path MCPacker::BlobStore::GetPath(const Digest& digest) const
+{
+    const auto hex = ToHex(digest);
+    return root / hex.substr(0, 2) / hex;
+}
+
+bool MCPacker::BlobStore::Contains(const Digest& digest) const
+{
+    return fs::is_regular_file(GetPath(digest));
+}
+
+const fs::path& MCPacker::BlobStore::GetRoot() const
+{
+    return root;
+}
+
+std::vector<fs::path> MCPacker::BlobStore::CollectGarbage(const std::set<Digest>& referenced) const
+{
+    std::vector<fs::path> removed;
+    if (not fs::is_directory(root))
+    {
+        return removed;
+    }
+
+    for (const auto& entry : fs::recursive_directory_iterator(root))
+    {
+        // Anything not named after a digest, like a blob being written right now, is not a blob
+        const auto digest = FromHex(entry.path().filename().string());
+        if (entry.is_regular_file() and digest.has_value() and not referenced.contains(*digest))
+        {
+            removed.push_back(entry.path());
+        }
+    }
+
+    for (const auto& path : removed)
+    {
+        fs::remove(path);
+    }
+    return removed;
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOB_STORE_HPP
+#define BLOB_STORE_HPP
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <Utility.hpp>
+
+typedef struct evp_md_ctx_st EVP_MD_CTX;
+
+namespace MCPacker
+{
+    /// @brief Content-addressed store of mods shared by packs
+    /// @details Every blob is a mod's data as is, kept in `<root>/<first two hex digits>/<SHA-256 in hex>`,
+    /// so the same jar is stored once however many packs reference it.
+    /// Blobs are written into a temporary file first and renamed into place, so a blob under its
+    /// digest is always complete.
+    /// A blob put for a pack is not referenced until the pack is written, so writers of packs and
+    /// garbage collection exclude each other through the store's `Lock`.
+    class BlobStore
+    {
+    public:
+        using Digest = std::array<uint8_t, 32>;
+
+        /// @brief Writes a blob whose digest is not known in advance
+        class Writer final : private boost::noncopyable
+        {
+        private:
+            const BlobStore& store;
+            std::filesystem::path temporaryPath;
+            Utility::Definitions::OutputBinaryFile file;
+            EVP_MD_CTX* context;
+            bool committed;
+
+        public:
+            Writer(const BlobStore& store);
+            ~Writer();
+
+            void Write(std::span<const Utility::Definitions::Byte> data);
+
+            /// @brief Move the written blob into the store
+            /// @return Digest of the blob, if the store already had it the written copy is dropped
+            Digest Commit();
+        };
+
+        /// @brief Advisory lock on the whole store, `<root>/lock`, which also excludes other processes sharing the store
+        /// @details Writers of packs hold it shared from putting the first blob until the pack referencing
+        /// the blobs is in place, garbage collection holds it exclusively from reading the packs until
+        /// the blobs are removed. A thread must not take it again while holding it
+        class Lock final : private boost::noncopyable
+        {
+        public:
+            enum class Mode
+            {
+                Shared,
+                Exclusive
+            };
+
+        private:
+            int fd;
+
+        public:
+            /// @brief Wait until the lock is acquired in `mode`
+            /// @throws std::runtime_error if the lock file cannot be opened or locked
+            Lock(const BlobStore& store, Mode mode);
+            ~Lock();
+        };
+
+    private:
+        std::filesystem::path root;
+
+    public:
+        /// @brief Open the store at `root`, the directory is created when the first blob is put
+        BlobStore(std::filesystem::path root);
+
+        static Digest Hash(std::span<const Utility::Definitions::Byte> data);
+        static std::string ToHex(const Digest& digest);
+        static std::optional<Digest> FromHex(std::string_view hex);
+
+        /// @brief Put `data` into the store unless it is already there
+        Digest Put(std::span<const Utility::Definitions::Byte> data) const;
+
+        std::filesystem::path GetPath(const Digest& digest) const;
+        bool Contains(const Digest& digest) const;
+        const std::filesystem::path& GetRoot() const;
+
+        /// @brief Remove every blob not in `referenced`
+        /// @details The caller must hold an exclusive `Lock` from before it starts collecting `referenced`
+        /// until this returns, otherwise blobs of packs being written are removed
+        /// @return Paths of the removed blobs
+        std::vector<std::filesystem::path> CollectGarbage(const std::set<Digest>& referenced) const;
+    };
+}
+
+#endif //BLOB_STORE_HPP
\ No newline at end of file
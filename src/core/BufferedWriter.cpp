@@ -0,0 +1,205 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/format.hpp>
+#include "BufferedWriter.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+MCPacker::BufferedWriter::BufferedWriter(fs::path path)
+    :
+    path(std::move(path)),
+    fd(-1),
+    buffer(static_cast<Byte*>(std::aligned_alloc(Alignment, BufferSize)), &std::free),
+    buffered(0),
+    position(0)
+{
+    if (buffer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    fd = open(this->path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+    {
+        const auto message = format("Unable to create file %1%: %2%") % std::quoted(this->path.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+}
+
+MCPacker::BufferedWriter::~BufferedWriter()
+{
+    if (fd != -1)
+    {
+        close(fd);
+    }
+}
+
+void MCPacker::BufferedWriter::Submit(std::span<iovec> vectors)
+{
+    while (not vectors.empty())
+    {
+        const auto written = writev(fd, vectors.data(), static_cast<int>(vectors.size()));
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            const auto message = format("Unable to write file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+            throw std::runtime_error(message.str());
+        }
+
+        // Skip what was written and continue from the middle of the vector it stopped in
+        auto remaining = static_cast<size_t>(written);
+        while (not vectors.empty() and remaining >= vectors.front().iov_len)
+        {
+            remaining -= vectors.front().iov_len;
+            vectors = vectors.subspan(1);
+        }
+        if (not vectors.empty())
+        {
+            vectors.front().iov_base = static_cast<Byte*>(vectors.front().iov_base) + remaining;
+            vectors.front().iov_len -= remaining;
+        }
+    }
+}
+
+void MCPacker::BufferedWriter::Write(std::span<const Byte> data)
+{
+    if (data.empty())
+    {
+        return;
+    }
+
+    position += data.size();
+    if (data.size() <= BufferSize - buffered)
+    {
+        std::memcpy(buffer.get() + buffered, data.data(), data.size());
+        buffered += data.size();
+        return;
+    }
+
+    if (data.size() >= BufferSize)
+    {
+        std::array<iovec, 2> vectors = {{
+            {.iov_base = buffer.get(), .iov_len = buffered},
+            {.iov_base = const_cast<Byte*>(data.data()), .iov_len = data.size()}
+        }};
+        Submit(std::span(vectors).subspan(buffered == 0 ? 1 : 0));
+        buffered = 0;
+        return;
+    }
+
+    // Top the buffer up, submit it and keep the rest for later
+    const auto head = BufferSize - buffered;
+    std::memcpy(buffer.get() + buffered, data.data(), head);
+    buffered = BufferSize;
+    Flush();
+    std::memcpy(buffer.get(), data.data() + head, data.size() - head);
+    buffered = data.size() - head;
+}
+
+void MCPacker::BufferedWriter::Fill(uint64_t count, Byte value)
+{
+    while (count != 0)
+    {
+        if (buffered == BufferSize)
+        {
+            Flush();
+        }
+        const auto chunk = static_cast<size_t>(std::min<uint64_t>(count, BufferSize - buffered));
+        std::memset(buffer.get() + buffered, value, chunk);
+        buffered += chunk;
+        position += chunk;
+        count -= chunk;
+    }
+}
+
+void MCPacker::BufferedWriter::WriteAt(uint64_t offset, std::span<const Byte> data)
+{
+    Flush();
+    while (not data.empty())
+    {
+        const auto written = pwrite(fd, data.data(), data.size(), static_cast<off_t>(offset));
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            const auto message = format("Unable to write file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+            throw std::runtime_error(message.str());
+        }
+        data = data.subspan(static_cast<size_t>(written));
+        offset += static_cast<uint64_t>(written);
+    }
+}
+
+void MCPacker::BufferedWriter::Truncate(uint64_t length)
+{
+    if (length > position)
+    {
+        throw std::logic_error("Unable to truncate a file past its end!");
+    }
+
+    Flush();
+    if (ftruncate(fd, static_cast<off_t>(length)) == -1 or lseek(fd, static_cast<off_t>(length), SEEK_SET) == -1)
+    {
+        const auto message = format("Unable to truncate file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+    position = length;
+}
+
+void MCPacker::BufferedWriter::Flush()
+{
+    if (buffered == 0)
+    {
+        return;
+    }
+    iovec vector{.iov_base = buffer.get(), .iov_len = buffered};
+    Submit(std::span(&vector, 1));
+    buffered = 0;
+}
+
+void MCPacker::BufferedWriter::Close()
+{
+    Flush();
+    const int closed = close(fd);
+    fd = -1;
+    if (closed == -1)
+    {
+        const auto message = format("Unable to write file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+}
+
+uint64_t MCPacker::BufferedWriter::GetPosition() const
+{
+    return position;
+}
\ No newline at end of file
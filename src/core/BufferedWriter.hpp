@@ -0,0 +1,85 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUFFERED_WRITER_HPP
+#define BUFFERED_WRITER_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <sys/uio.h>
+#include <boost/noncopyable.hpp>
+#include <Utility.hpp>
+
+namespace MCPacker
+{
+    /// @brief Writes a file sequentially through a large buffer
+    /// @details Small writes are gathered in a page-aligned buffer of `BufferSize` bytes which is submitted once it is full.
+    /// Data at least as large as the buffer is never copied: it is submitted together with whatever is buffered
+    /// by a single `writev` call. Destroying the writer without `Close` discards the buffered data
+    class BufferedWriter final : private boost::noncopyable
+    {
+    public:
+        static constexpr size_t BufferSize = 1 << 20;
+        static constexpr size_t Alignment = 4096;
+
+    private:
+        std::filesystem::path path;
+        int fd;
+        std::unique_ptr<Utility::Definitions::Byte, decltype(&std::free)> buffer;
+        size_t buffered;
+
+        /// @brief Position in the file the next write goes to, buffered data included
+        uint64_t position;
+
+        /// @brief Write all of `vectors`, retrying after partial writes
+        void Submit(std::span<iovec> vectors);
+
+    public:
+        /// @brief Create `path` or truncate it if it exists
+        /// @throws std::runtime_error if the file cannot be created
+        BufferedWriter(std::filesystem::path path);
+        ~BufferedWriter();
+
+        /// @throws std::runtime_error if the data cannot be written
+        void Write(std::span<const Utility::Definitions::Byte> data);
+
+        /// @brief Write `count` copies of `value`
+        void Fill(uint64_t count, Utility::Definitions::Byte value);
+
+        /// @brief Overwrite data written earlier at `offset`, e.g. to fill in a placeholder
+        /// @details The buffer is submitted first, the position of the next write does not change
+        void WriteAt(uint64_t offset, std::span<const Utility::Definitions::Byte> data);
+
+        /// @brief Discard everything written from `length` on, the next write goes there
+        /// @throws std::runtime_error if the file cannot be truncated
+        void Truncate(uint64_t length);
+
+        /// @brief Submit the buffered data
+        void Flush();
+
+        /// @brief Flush and close the file
+        /// @throws std::runtime_error if the file cannot be written
+        void Close();
+
+        uint64_t GetPosition() const;
+    };
+}
+
+#endif //BUFFERED_WRITER_HPP
\ No newline at end of file
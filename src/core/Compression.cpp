@@ -0,0 +1,211 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <zstd.h>
+#include <boost/format.hpp>
+#include "Compression.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+
+namespace
+{
+    void ThrowOnError(size_t result)
+    {
+        if (ZSTD_isError(result))
+        {
+            const auto message = format("Zstandard error: %1%") % ZSTD_getErrorName(result);
+            throw std::runtime_error(message.str());
+        }
+    }
+}
+
+MCPacker::CompressionOptions::CompressionOptions()
+    :
+    CompressionOptions(Codec::Store, 0)
+{
+
+}
+
+MCPacker::CompressionOptions::CompressionOptions(Codec codec, int level, unsigned workers)
+    :
+    codec(codec),
+    level(level),
+    workers(workers)
+{
+
+}
+
+MCPacker::Compressor::Compressor(const CompressionOptions& options)
+    :
+    options(options),
+    context(nullptr)
+{
+    switch (options.codec)
+    {
+        case Codec::Store:
+            break;
+
+        case Codec::Zstd:
+            context = ZSTD_createCCtx();
+            if (context == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            ThrowOnError(ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, options.level));
+            break;
+
+        default:
+            throw std::invalid_argument("Unrecognised codec");
+    }
+}
+
+MCPacker::Compressor::~Compressor()
+{
+    ZSTD_freeCCtx(context);
+}
+
+void MCPacker::Compressor::Compress(std::span<const Byte> input, bool last, std::vector<Byte>& output)
+{
+    if (options.codec == Codec::Store)
+    {
+        output.insert(std::end(output), std::begin(input), std::end(input));
+        return;
+    }
+
+    ZSTD_inBuffer inBuffer{.src = input.data(), .size = input.size(), .pos = 0};
+    const auto mode = last ? ZSTD_e_end : ZSTD_e_continue;
+    for (bool done = false; not done; )
+    {
+        const auto outputStart = output.size();
+        output.resize(outputStart + ZSTD_CStreamOutSize());
+        ZSTD_outBuffer outBuffer{.dst = output.data() + outputStart, .size = output.size() - outputStart, .pos = 0};
+
+        const auto remaining = ZSTD_compressStream2(context, &outBuffer, &inBuffer, mode);
+        ThrowOnError(remaining);
+        output.resize(outputStart + outBuffer.pos);
+
+        // The frame is finished when everything is flushed, otherwise it is enough to consume the input
+        done = last ? remaining == 0 : inBuffer.pos == inBuffer.size;
+    }
+}
+
+std::vector<Byte> MCPacker::Compressor::CompressAll(std::span<const Byte> data, const CompressionOptions& options)
+{
+    if (options.codec == Codec::Store)
+    {
+        return std::vector<Byte>(std::begin(data), std::end(data));
+    }
+
+    std::vector<Byte> compressed(ZSTD_compressBound(data.size()));
+    const auto compressedSize = ZSTD_compress(compressed.data(), compressed.size(), data.data(), data.size(), options.level);
+    ThrowOnError(compressedSize);
+    compressed.resize(compressedSize);
+    return compressed;
+}
+
+MCPacker::Decompressor::Decompressor(Codec codec)
+    :
+    codec(codec),
+    context(nullptr)
+{
+    switch (codec)
+    {
+        case Codec::Store:
+            break;
+
+        case Codec::Zstd:
+            context = ZSTD_createDCtx();
+            if (context == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            break;
+
+        default:
+            throw std::invalid_argument("Unrecognised codec");
+    }
+}
+
+MCPacker::Decompressor::~Decompressor()
+{
+    ZSTD_freeDCtx(context);
+}
+
+void MCPacker::Decompressor::Decompress(std::span<const Byte> input, std::vector<Byte>& output, uint64_t limit)
+{
+    if (codec == Codec::Store)
+    {
+        if (input.size() > limit)
+        {
+            throw std::runtime_error("Size of stored data does not match!");
+        }
+        output.insert(std::end(output), std::begin(input), std::end(input));
+        return;
+    }
+
+    ZSTD_inBuffer inBuffer{.src = input.data(), .size = input.size(), .pos = 0};
+    uint64_t produced = 0;
+    for (bool flushed = false; inBuffer.pos < inBuffer.size or not flushed; )
+    {
+        // One byte of room past the limit is enough to tell that the data decompresses to more than it
+        const auto outputStart = output.size();
+        output.resize(outputStart + static_cast<size_t>(std::min<uint64_t>(ZSTD_DStreamOutSize(), limit - produced + 1)));
+        ZSTD_outBuffer outBuffer{.dst = output.data() + outputStart, .size = output.size() - outputStart, .pos = 0};
+
+        ThrowOnError(ZSTD_decompressStream(context, &outBuffer, &inBuffer));
+        output.resize(outputStart + outBuffer.pos);
+        produced += outBuffer.pos;
+        if (produced > limit)
+        {
+            throw std::runtime_error("Size of decompressed data does not match!");
+        }
+
+        // A partially filled output buffer means the decoder has nothing more to give for now
+        flushed = outBuffer.pos < outBuffer.size;
+    }
+}
+
+void MCPacker::Decompressor::DecompressAll(Codec codec, std::span<const Byte> data, std::span<Byte> output)
+{
+    switch (codec)
+    {
+        case Codec::Store:
+            if (data.size() != output.size())
+            {
+                throw std::runtime_error("Size of stored data does not match!");
+            }
+            std::ranges::copy(data, std::begin(output));
+            break;
+
+        case Codec::Zstd:
+        {
+            const auto decompressedSize = ZSTD_decompress(output.data(), output.size(), data.data(), data.size());
+            ThrowOnError(decompressedSize);
+            if (decompressedSize != output.size())
+            {
+                throw std::runtime_error("Size of decompressed data does not match!");
+            }
+            break;
+        }
+
+        default:
+            throw std::invalid_argument("Unrecognised codec");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <Utility.hpp>
+
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+
+namespace MCPacker
+{
+    /// @brief Codecs mods' data can be stored with in a pack, the value is what is written into the index
+    enum class Codec : uint8_t
+    {
+        /// @brief Data is stored as is
+        Store = 0,
+        Zstd = 1
+    };
+
+    /// @brief Defines how to compress mods when writing a pack
+    struct CompressionOptions
+    {
+        Codec codec;
+
+        /// @brief Compression level, its meaning depends on the codec and it is ignored by `Codec::Store`
+        int level;
+
+        /// @brief Number of mods compressed concurrently, `0` means one per hardware thread.
+        /// It does not affect the written pack, which is the same for any number of workers
+        unsigned workers;
+
+        CompressionOptions();
+        CompressionOptions(Codec codec, int level, unsigned workers = 1);
+    };
+
+    /// @brief Compresses data in one go or chunk by chunk
+    class Compressor final : private boost::noncopyable
+    {
+    private:
+        CompressionOptions options;
+        ZSTD_CCtx* context;
+
+    public:
+        Compressor(const CompressionOptions& options);
+        ~Compressor();
+
+        /// @brief Compress the next chunk of data
+        /// @param input Next chunk of the data
+        /// @param last Whether this is the last chunk, the compressed data is complete only after it
+        /// @param output Vector to append compressed data to
+        void Compress(std::span<const Utility::Definitions::Byte> input, bool last, std::vector<Utility::Definitions::Byte>& output);
+
+        /// @brief Compress the whole `data` at once
+        static std::vector<Utility::Definitions::Byte> CompressAll(std::span<const Utility::Definitions::Byte> data, const CompressionOptions& options);
+    };
+
+    /// @brief Decompresses data in one go or chunk by chunk
+    class Decompressor final : private boost::noncopyable
+    {
+    private:
+        Codec codec;
+        ZSTD_DCtx* context;
+
+    public:
+        Decompressor(Codec codec);
+        ~Decompressor();
+
+        /// @brief Decompress the next chunk of compressed data
+        /// @param output Vector to append decompressed data to
+        /// @param limit Most bytes the chunk may decompress to, output is never grown much past it
+        /// @throws std::runtime_error if the data is corrupted or decompresses to more than `limit` bytes
+        void Decompress(std::span<const Utility::Definitions::Byte> input, std::vector<Utility::Definitions::Byte>& output, uint64_t limit);
+
+        /// @brief Decompress the whole `data` into `output`, which must be of the exact decompressed size
+        /// @throws std::runtime_error if the data is corrupted or does not fit `output` exactly
+        static void DecompressAll(Codec codec, std::span<const Utility::Definitions::Byte> data, std::span<Utility::Definitions::Byte> output);
+    };
+}
+
+#endif //COMPRESSION_HPP
\ No newline at end of file
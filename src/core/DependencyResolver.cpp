@@ -0,0 +1,515 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <compare>
+#include <stdexcept>
+#include <utility>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/format.hpp>
+#include "DependencyResolver.hpp"
+
+using boost::format;
+
+namespace
+{
+    using MCPacker::ModManifest;
+    using Loader = ModManifest::Loader;
+    using Kind = ModManifest::Dependency::Kind;
+
+    /// @brief IDs of the game, the loaders and Java, which are provided by the environment rather than by mods
+    constexpr std::array<std::string_view, 9> EnvironmentIDs = {
+        "minecraft", "java", "fabricloader", "quilt_loader", "forge", "neoforge", "fml", "javafml", "mcp"
+    };
+
+    bool IsEnvironmentID(const std::string& id)
+    {
+        // Legacy Forge mods write `Forge` and `FML`
+        return std::ranges::find(EnvironmentIDs, boost::algorithm::to_lower_copy(id)) != std::end(EnvironmentIDs);
+    }
+
+    std::string_view Trim(std::string_view text)
+    {
+        const auto begin = text.find_first_not_of(" \t");
+        if (begin == std::string_view::npos)
+        {
+            return {};
+        }
+        return text.substr(begin, text.find_last_not_of(" \t") - begin + 1);
+    }
+
+    bool IsNumber(std::string_view component)
+    {
+        return not component.empty() and std::ranges::all_of(component,
+            [](char c)
+            {
+                return std::isdigit(static_cast<unsigned char>(c)) != 0;
+            });
+    }
+
+    bool IsWildcard(std::string_view component)
+    {
+        return component == "x" or component == "X" or component == "*";
+    }
+
+    /// @brief Numbers are compared by value and rank below words, words are compared as text
+    std::strong_ordering CompareComponents(std::string_view left, std::string_view right)
+    {
+        const bool leftIsNumber = IsNumber(left), rightIsNumber = IsNumber(right);
+        if (leftIsNumber and rightIsNumber)
+        {
+            // Comparing digits instead of parsing them never overflows
+            left.remove_prefix(std::min(left.find_first_not_of('0'), left.size()));
+            right.remove_prefix(std::min(right.find_first_not_of('0'), right.size()));
+            if (left.size() != right.size())
+            {
+                return left.size() <=> right.size();
+            }
+            return left <=> right;
+        }
+        if (leftIsNumber != rightIsNumber)
+        {
+            return leftIsNumber ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+        return left <=> right;
+    }
+
+    /// @brief Version split into components, e.g. `1.20.1-beta.2+build.5` into release `1`, `20`, `1`
+    /// and pre-release `beta`, `2`. Build metadata does not take part in comparisons.
+    /// It only refers to the text it was made from
+    class Version
+    {
+        std::vector<std::string_view> release;
+        std::vector<std::string_view> preRelease;
+
+        /// @brief Position of the first wildcard component such as in `1.2.x`, the components after it are dropped
+        std::optional<size_t> wildcard;
+
+        static std::vector<std::string_view> Split(std::string_view text)
+        {
+            std::vector<std::string_view> components;
+            while (not text.empty())
+            {
+                const auto separator = text.find('.');
+                components.push_back(text.substr(0, separator));
+                if (separator == std::string_view::npos)
+                {
+                    break;
+                }
+                text.remove_prefix(separator + 1);
+            }
+            return components;
+        }
+
+        /// @brief Component of the release part, missing ones are zeroes, so `1.2` equals `1.2.0`
+        std::string_view ReleaseAt(size_t position) const
+        {
+            return position < release.size() ? release[position] : "0";
+        }
+
+    public:
+        explicit Version(std::string_view text)
+            :
+            release(),
+            preRelease(),
+            wildcard()
+        {
+            text = Trim(text);
+            text = text.substr(0, text.find('+'));
+            const auto separator = text.find('-');
+            release = Split(text.substr(0, separator));
+            if (separator != std::string_view::npos)
+            {
+                preRelease = Split(text.substr(separator + 1));
+            }
+
+            const auto found = std::ranges::find_if(release, IsWildcard);
+            if (found != std::end(release))
+            {
+                wildcard = static_cast<size_t>(found - std::begin(release));
+                release.erase(found, std::end(release));
+                preRelease.clear();
+            }
+        }
+
+        std::optional<size_t> GetWildcard() const
+        {
+            return wildcard;
+        }
+
+        /// @brief Check whether the first `count` release components equal the ones of `prefix`
+        bool StartsWith(const Version& prefix, size_t count) const
+        {
+            for (size_t position = 0; position < count; ++position)
+            {
+                if (CompareComponents(ReleaseAt(position), prefix.ReleaseAt(position)) != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::strong_ordering operator<=>(const Version& other) const
+        {
+            for (size_t position = 0; position < std::max(release.size(), other.release.size()); ++position)
+            {
+                const auto order = CompareComponents(ReleaseAt(position), other.ReleaseAt(position));
+                if (order != 0)
+                {
+                    return order;
+                }
+            }
+
+            // A pre-release comes before the release itself
+            if (preRelease.empty() != other.preRelease.empty())
+            {
+                return preRelease.empty() ? std::strong_ordering::greater : std::strong_ordering::less;
+            }
+            for (size_t position = 0; position < std::min(preRelease.size(), other.preRelease.size()); ++position)
+            {
+                const auto order = CompareComponents(preRelease[position], other.preRelease[position]);
+                if (order != 0)
+                {
+                    return order;
+                }
+            }
+            return preRelease.size() <=> other.preRelease.size();
+        }
+
+        bool operator==(const Version& other) const
+        {
+            return (*this <=> other) == 0;
+        }
+    };
+
+    /// @brief Check a version against a Maven range like Forge does, e.g. `[1.2,2.0)`, `(,3]`, `[1.5]` or `[1,2),[3,)`
+    /// @details A bare version is only a recommendation in Maven and accepts every version
+    /// @return `std::nullopt` if the range is malformed
+    std::optional<bool> IsInMavenRange(const Version& version, std::string_view range)
+    {
+        if (range.find_first_of("[(") == std::string_view::npos)
+        {
+            return true;
+        }
+
+        for (size_t position = range.find_first_not_of(" ,"); position != std::string_view::npos;
+            position = range.find_first_not_of(" ,", position))
+        {
+            const auto open = range[position];
+            const auto close = range.find_first_of("])", position);
+            if ((open != '[' and open != '(') or close == std::string_view::npos)
+            {
+                return std::nullopt;
+            }
+            const auto bounds = range.substr(position + 1, close - position - 1);
+            const bool inclusiveLower = open == '[', inclusiveUpper = range[close] == ']';
+            position = close + 1;
+
+            const auto separator = bounds.find(',');
+            if (separator == std::string_view::npos)
+            {
+                if (version == Version(bounds))
+                {
+                    return true;
+                }
+                continue;
+            }
+
+            const auto lower = Trim(bounds.substr(0, separator)), upper = Trim(bounds.substr(separator + 1));
+            bool inRange = true;
+            if (not lower.empty())
+            {
+                inRange = inclusiveLower ? version >= Version(lower) : version > Version(lower);
+            }
+            if (inRange and not upper.empty())
+            {
+                inRange = inclusiveUpper ? version <= Version(upper) : version < Version(upper);
+            }
+            if (inRange)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Check a version against a single Fabric predicate such as `>=1.2`, `~1.2.3`, `^1.2`, `1.2.x` or `1.2.3`
+    bool MatchesFabricPredicate(const Version& version, std::string_view predicate)
+    {
+        constexpr std::array<std::string_view, 7> Operators = {">=", "<=", ">", "<", "=", "~", "^"};
+        std::string_view operation;
+        for (const auto candidate : Operators)
+        {
+            if (predicate.starts_with(candidate))
+            {
+                operation = candidate;
+                break;
+            }
+        }
+
+        const Version bound(predicate.substr(operation.size()));
+        if (operation.empty() or operation == "=")
+        {
+            return bound.GetWildcard().has_value() ? version.StartsWith(bound, *bound.GetWildcard()) : version == bound;
+        }
+        if (operation == ">=")
+        {
+            return version >= bound;
+        }
+        if (operation == "<=")
+        {
+            return version <= bound;
+        }
+        if (operation == ">")
+        {
+            return version > bound;
+        }
+        if (operation == "<")
+        {
+            return version < bound;
+        }
+        // `~` keeps the major and the minor version, `^` only the major one
+        return version >= bound and version.StartsWith(bound, operation == "~" ? 2 : 1);
+    }
+
+    /// @brief Check a version against Fabric predicates, which are separated by spaces when all of them must hold
+    /// and by `||` when any of the alternatives is enough
+    bool IsInFabricRange(const Version& version, std::string_view range)
+    {
+        while (true)
+        {
+            const auto separator = range.find("||");
+            auto alternative = Trim(range.substr(0, separator));
+            bool matches = true;
+            while (matches and not alternative.empty())
+            {
+                const auto end = alternative.find_first_of(" \t");
+                const auto predicate = alternative.substr(0, end);
+                matches = predicate == "*" or MatchesFabricPredicate(version, predicate);
+                alternative = Trim(end == std::string_view::npos ? std::string_view() : alternative.substr(end));
+            }
+            if (matches)
+            {
+                return true;
+            }
+            if (separator == std::string_view::npos)
+            {
+                return false;
+            }
+            range.remove_prefix(separator + 2);
+        }
+    }
+
+    std::string WithRange(const std::string& id, const std::string& versionRange)
+    {
+        return versionRange.empty() ? id : id + " " + versionRange;
+    }
+}
+
+MCPacker::DependencyResolver::Problem::Problem(Kind kind, size_t mod, std::optional<size_t> other, std::string id, std::string versionRange)
+    :
+    kind(kind),
+    mod(mod),
+    other(other),
+    id(std::move(id)),
+    versionRange(std::move(versionRange))
+{
+
+}
+
+MCPacker::DependencyResolver::DependencyResolver(std::vector<std::string> names, std::vector<std::optional<ModManifest>> manifests)
+    :
+    names(std::move(names)),
+    manifests(std::move(manifests)),
+    providers(),
+    dependencies(),
+    loader(),
+    problems()
+{
+    if (this->names.size() != this->manifests.size())
+    {
+        throw std::invalid_argument("There must be a manifest for every mod!");
+    }
+    Resolve();
+}
+
+bool MCPacker::DependencyResolver::IsInRange(std::string_view version, std::string_view range, ModManifest::Loader loader)
+{
+    // Nothing can be said about mods which do not tell their version
+    if (Trim(range).empty() or Trim(version).empty())
+    {
+        return true;
+    }
+
+    const Version parsed(version);
+    if (loader == Loader::Fabric)
+    {
+        return IsInFabricRange(parsed, range);
+    }
+    return IsInMavenRange(parsed, range).value_or(true);
+}
+
+void MCPacker::DependencyResolver::Resolve()
+{
+    dependencies.resize(manifests.size());
+
+    std::array<size_t, 4> modsPerLoader = {};
+    for (size_t mod = 0; mod < manifests.size(); ++mod)
+    {
+        const auto& manifest = manifests[mod];
+        if (not manifest.has_value())
+        {
+            continue;
+        }
+        ++modsPerLoader[static_cast<size_t>(manifest->loader)];
+
+        providers[manifest->id].push_back(mod);
+        for (const auto& id : manifest->provides)
+        {
+            auto& modsWithID = providers[id];
+            if (modsWithID.empty() or modsWithID.back() != mod)
+            {
+                modsWithID.push_back(mod);
+            }
+        }
+    }
+    if (std::ranges::any_of(modsPerLoader, [](size_t count) { return count != 0; }))
+    {
+        loader = static_cast<ModManifest::Loader>(std::ranges::max_element(modsPerLoader) - std::begin(modsPerLoader));
+    }
+
+    for (size_t mod = 0; mod < manifests.size(); ++mod)
+    {
+        const auto& manifest = manifests[mod];
+        if (not manifest.has_value())
+        {
+            continue;
+        }
+
+        if (manifest->loader != *loader)
+        {
+            problems.emplace_back(Problem::Kind::WrongLoader, mod, std::nullopt, manifest->id, std::string());
+        }
+
+        // Mods declaring the ID as their own come before this one in the list of its providers
+        for (const auto other : providers[manifest->id])
+        {
+            if (other == mod)
+            {
+                break;
+            }
+            if (manifests[other]->id == manifest->id)
+            {
+                problems.emplace_back(Problem::Kind::Duplicate, mod, other, manifest->id, std::string());
+                break;
+            }
+        }
+
+        for (const auto& dependency : manifest->dependencies)
+        {
+            if (IsEnvironmentID(dependency.id))
+            {
+                continue;
+            }
+
+            std::optional<size_t> candidate;
+            bool satisfied = false;
+            for (const auto other : GetProviders(dependency.id))
+            {
+                if (other == mod)
+                {
+                    continue;
+                }
+                candidate = candidate.value_or(other);
+                if (not IsInRange(manifests[other]->version, dependency.versionRange, manifest->loader))
+                {
+                    continue;
+                }
+
+                satisfied = true;
+                if (dependency.kind == Kind::Conflict)
+                {
+                    problems.emplace_back(Problem::Kind::Conflict, mod, other, dependency.id, dependency.versionRange);
+                }
+                else if (std::ranges::find(dependencies[mod], other) == std::end(dependencies[mod]))
+                {
+                    dependencies[mod].push_back(other);
+                }
+            }
+
+            if (dependency.kind == Kind::Required and not satisfied)
+            {
+                const auto kind = candidate.has_value() ? Problem::Kind::WrongVersion : Problem::Kind::MissingDependency;
+                problems.emplace_back(kind, mod, candidate, dependency.id, dependency.versionRange);
+            }
+        }
+    }
+}
+
+const std::vector<MCPacker::DependencyResolver::Problem>& MCPacker::DependencyResolver::GetProblems() const
+{
+    return problems;
+}
+
+std::span<const size_t> MCPacker::DependencyResolver::GetProviders(std::string_view id) const
+{
+    const auto found = providers.find(std::string(id));
+    if (found == std::end(providers))
+    {
+        return {};
+    }
+    return found->second;
+}
+
+const std::vector<size_t>& MCPacker::DependencyResolver::GetDependencies(size_t mod) const
+{
+    return dependencies.at(mod);
+}
+
+std::optional<MCPacker::ModManifest::Loader> MCPacker::DependencyResolver::GetLoader() const
+{
+    return loader;
+}
+
+std::string MCPacker::DependencyResolver::Describe(const Problem& problem) const
+{
+    const auto& name = names.at(problem.mod);
+    const auto& other = problem.other.has_value() ? names.at(*problem.other) : std::string();
+    switch (problem.kind)
+    {
+        case Problem::Kind::MissingDependency:
+            return (format("%1% requires %2%, which is not in the pack") % name % WithRange(problem.id, problem.versionRange)).str();
+
+        case Problem::Kind::WrongVersion:
+            return (format("%1% requires %2%, but %3% has version %4%") % name % WithRange(problem.id, problem.versionRange)
+                % other % manifests.at(*problem.other)->version).str();
+
+        case Problem::Kind::Conflict:
+            return (format("%1% does not work with %2% (%3%)") % name % other % WithRange(problem.id, problem.versionRange)).str();
+
+        case Problem::Kind::Duplicate:
+            return (format("%1% and %2% are both mod %3%") % other % name % problem.id).str();
+
+        case Problem::Kind::WrongLoader:
+            return (format("%1% is made for %2%, but most mods of the pack are for %3%") % name
+                % ModManifest::GetLoaderName(manifests.at(problem.mod)->loader) % ModManifest::GetLoaderName(*loader)).str();
+    }
+    return problem.id;
+}
\ No newline at end of file
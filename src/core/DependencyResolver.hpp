@@ -0,0 +1,115 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DEPENDENCY_RESOLVER_HPP
+#define DEPENDENCY_RESOLVER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "ModManifest.hpp"
+
+namespace MCPacker
+{
+    /// @brief Graph of the dependencies between the mods of a pack, built from their manifests
+    /// @details Every ID a mod declares, its own and the ones it provides, is put into a hash table,
+    /// so each dependency is resolved with a single lookup instead of comparing every pair of mods.
+    /// Version ranges are read in the syntax of the dependent mod's loader: Maven ranges such as `[1.2,2)`
+    /// for Forge and NeoForge mods, and predicates such as `>=1.2 <2`, `~1.2` or `1.x` for Fabric ones.
+    /// Dependencies on the game, the loader and Java are provided by the environment rather than the pack and are never reported.
+    /// Mods without a manifest take no part in the graph, so a dependency only they satisfy is reported as missing
+    class DependencyResolver
+    {
+    public:
+        struct Problem
+        {
+            enum class Kind : uint8_t
+            {
+                /// @brief No mod of the pack provides a required dependency
+                MissingDependency,
+                /// @brief A required dependency is provided, but in no version within the range
+                WrongVersion,
+                /// @brief The mod does not work together with another mod of the pack
+                Conflict,
+                /// @brief The mod has the same ID as an earlier mod of the pack
+                Duplicate,
+                /// @brief The mod is made for another loader than most mods of the pack
+                WrongLoader
+            };
+
+            Kind kind;
+
+            /// @brief Position of the mod with the problem in the pack
+            size_t mod;
+
+            /// @brief Position of the other mod involved, if there is one
+            std::optional<size_t> other;
+
+            /// @brief ID the problem is about and the range the mod declared for it
+            std::string id;
+            std::string versionRange;
+
+            Problem(Kind kind, size_t mod, std::optional<size_t> other, std::string id, std::string versionRange);
+        };
+
+    private:
+        std::vector<std::string> names;
+        std::vector<std::optional<ModManifest>> manifests;
+
+        /// @brief Positions of the mods declaring each ID, either as their own or as a provided one
+        std::unordered_map<std::string, std::vector<size_t>> providers;
+
+        /// @brief Mods satisfying the dependencies of every mod, required and optional ones
+        std::vector<std::vector<size_t>> dependencies;
+
+        std::optional<ModManifest::Loader> loader;
+        std::vector<Problem> problems;
+
+        void Resolve();
+
+    public:
+        /// @param names Names of the mods' jars in the order of the pack
+        /// @param manifests Manifest of every mod, `std::nullopt` for mods without one
+        /// @throws std::invalid_argument if there is not a manifest for every mod
+        DependencyResolver(std::vector<std::string> names, std::vector<std::optional<ModManifest>> manifests);
+
+        /// @brief Check whether `version` of a mod is within `range` as written by a mod for `loader`
+        /// @details Ranges which cannot be understood accept every version
+        static bool IsInRange(std::string_view version, std::string_view range, ModManifest::Loader loader);
+
+        /// @brief Problems in the order of the mods they concern
+        const std::vector<Problem>& GetProblems() const;
+
+        /// @brief Positions of the mods declaring `id`
+        std::span<const size_t> GetProviders(std::string_view id) const;
+
+        /// @brief Positions of the mods the `mod`-th mod depends on
+        const std::vector<size_t>& GetDependencies(size_t mod) const;
+
+        /// @brief Loader most mods of the pack are made for, `std::nullopt` if no mod has a manifest
+        std::optional<ModManifest::Loader> GetLoader() const;
+
+        /// @brief Human-readable explanation of `problem`
+        std::string Describe(const Problem& problem) const;
+    };
+}
+
+#endif //DEPENDENCY_RESOLVER_HPP
\ No newline at end of file
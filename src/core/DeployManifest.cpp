@@ -0,0 +1,187 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <iomanip>
+#include <boost/format.hpp>
+#include "DeployManifest.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    template<typename T>
+    bool ReadNumber(InputBinaryFile& file, T& value)
+    {
+        std::array<Byte, sizeof(T)> serialised;
+        file.read(serialised.data(), serialised.size());
+        value = MCPacker::Utility::FromByteArray<T>(serialised);
+        return static_cast<bool>(file);
+    }
+}
+
+MCPacker::DeployManifest MCPacker::DeployManifest::Load(const fs::path& directory)
+{
+    DeployManifest manifest;
+
+    InputBinaryFile file(directory / FileName, std::ios::binary);
+    if (not file.is_open())
+    {
+        return manifest;
+    }
+
+    std::array<Byte, Magic.size()> magic;
+    uint16_t version = 0;
+    uint64_t recordCount = 0;
+    file.read(magic.data(), magic.size());
+    if (not file or magic != Magic or not ReadNumber(file, version) or version != CurrentVersion 
+        or not ReadNumber(file, recordCount))
+    {
+        // Stale or foreign manifests only cost rehashing the mods, so they are just ignored
+        return manifest;
+    }
+
+    for (uint64_t i = 0; i < recordCount; ++i)
+    {
+        uint16_t nameSize = 0;
+        Record record;
+        if (not ReadNumber(file, nameSize))
+        {
+            return DeployManifest();
+        }
+
+        std::string name(nameSize, '\0');
+        file.read(name.data(), name.size());
+
+        uint8_t hasChecksum = 0;
+        uint64_t checksum = 0;
+        uint8_t checksumAlgorithm = 0;
+        if (not ReadNumber(file, record.size) or not ReadNumber(file, record.modificationTime) or not ReadNumber(file, hasChecksum)
+            or not ReadNumber(file, checksum) or not ReadNumber(file, checksumAlgorithm)
+            or checksumAlgorithm > static_cast<uint8_t>(PackIndex::ChecksumAlgorithm::XXH3))
+        {
+            return DeployManifest();
+        }
+        if (hasChecksum != 0)
+        {
+            record.checksum = checksum;
+        }
+        record.checksumAlgorithm = static_cast<PackIndex::ChecksumAlgorithm>(checksumAlgorithm);
+        manifest.records.insert_or_assign(Utility::UTF8ToUTF32(name), record);
+    }
+
+    return manifest;
+}
+
+void MCPacker::DeployManifest::Save(const fs::path& directory) const
+{
+    const auto path = directory / FileName;
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    {
+        OutputBinaryFile file(temporaryPath, std::ios::binary | std::ios::trunc);
+        std::ranges::copy(Magic, std::ostreambuf_iterator(file));
+        std::ranges::copy(Utility::ToByteArray(CurrentVersion), std::ostreambuf_iterator(file));
+        std::ranges::copy(Utility::ToByteArray(static_cast<uint64_t>(records.size())), std::ostreambuf_iterator(file));
+        for (const auto& [name, record] : records)
+        {
+            const auto nameInUTF8 = Utility::UTF32ToUTF8(name);
+            std::ranges::copy(Utility::ToByteArray(static_cast<uint16_t>(nameInUTF8.size())), std::ostreambuf_iterator(file));
+            std::ranges::copy(nameInUTF8, std::ostreambuf_iterator(file));
+            std::ranges::copy(Utility::ToByteArray(record.size), std::ostreambuf_iterator(file));
+            std::ranges::copy(Utility::ToByteArray(record.modificationTime), std::ostreambuf_iterator(file));
+            std::ranges::copy(Utility::ToByteArray(static_cast<uint8_t>(record.checksum.has_value())), std::ostreambuf_iterator(file));
+            std::ranges::copy(Utility::ToByteArray(record.checksum.value_or(0)), std::ostreambuf_iterator(file));
+            std::ranges::copy(Utility::ToByteArray(static_cast<uint8_t>(record.checksumAlgorithm)), std::ostreambuf_iterator(file));
+        }
+
+        file.close();
+        if (not file)
+        {
+            const auto message = format("Unable to write file %1%!") % std::quoted(temporaryPath.string());
+            throw std::runtime_error(message.str());
+        }
+    }
+
+    // Replace the old manifest atomically, so it never describes half of a deploy
+    fs::rename(temporaryPath, path);
+}
+
+std::optional<MCPacker::DeployManifest::Record> MCPacker::DeployManifest::MakeRecord(const fs::path& modFile, std::optional<uint64_t> checksum, 
+    PackIndex::ChecksumAlgorithm checksumAlgorithm)
+{
+    std::error_code error;
+    const auto size = fs::file_size(modFile, error);
+    if (error)
+    {
+        return std::nullopt;
+    }
+    const auto modificationTime = fs::last_write_time(modFile, error);
+    if (error)
+    {
+        return std::nullopt;
+    }
+
+    return Record{
+        .size = size, 
+        .modificationTime = static_cast<int64_t>(modificationTime.time_since_epoch().count()), 
+        .checksum = checksum,
+        .checksumAlgorithm = checksumAlgorithm
+    };
+}
+
+bool MCPacker::DeployManifest::Matches(const fs::path& modFile, const Record& record)
+{
+    const auto current = MakeRecord(modFile, record.checksum, record.checksumAlgorithm);
+    return current.has_value() and current->size == record.size and current->modificationTime == record.modificationTime;
+}
+
+std::optional<MCPacker::DeployManifest::Record> MCPacker::DeployManifest::Find(std::u32string_view name) const
+{
+    const auto record = records.find(std::u32string(name));
+    if (record == std::end(records))
+    {
+        return std::nullopt;
+    }
+    return record->second;
+}
+
+void MCPacker::DeployManifest::Set(std::u32string_view name, const Record& record)
+{
+    records.insert_or_assign(std::u32string(name), record);
+}
+
+void MCPacker::DeployManifest::Remove(std::u32string_view name)
+{
+    records.erase(std::u32string(name));
+}
+
+std::map<std::u32string, MCPacker::DeployManifest::Record>::const_iterator MCPacker::DeployManifest::begin() const
+{
+    return std::begin(records);
+}
+
+std::map<std::u32string, MCPacker::DeployManifest::Record>::const_iterator MCPacker::DeployManifest::end() const
+{
+    return std::end(records);
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DEPLOY_MANIFEST_HPP
+#define DEPLOY_MANIFEST_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <Utility.hpp>
+#include "PackIndex.hpp"
+
+namespace MCPacker
+{
+    /// @brief Record of the mods deployed into a directory
+    /// @details The manifest is kept next to the mods and remembers the size, modification time
+    /// and, if it was known, checksum of every mod written into the directory, so later deploys can tell which mods
+    /// are unchanged without hashing them again, and which mods were put there by a deploy at all
+    class DeployManifest
+    {
+    public:
+        static constexpr std::string_view FileName = ".mcpacker-manifest";
+        static constexpr std::array<Utility::Definitions::Byte, 8> Magic = {'\x89', 'M', 'C', 'P', 'M', 'F', '\r', '\n'};
+        static constexpr uint16_t CurrentVersion = 3;
+
+        struct Record
+        {
+            uint64_t size;
+
+            /// @brief `std::filesystem::last_write_time` of the mod as a count of ticks
+            int64_t modificationTime;
+
+            /// @brief Checksum of the mod's data as computed by `PackIndex::Checksum`, `std::nullopt` if it was
+            /// not known without hashing the mod when it was written, the file is hashed when it is compared then
+            std::optional<uint64_t> checksum;
+
+            /// @brief Algorithm `checksum` is computed with, checksums of different algorithms never match
+            PackIndex::ChecksumAlgorithm checksumAlgorithm;
+        };
+
+    private:
+        std::map<std::u32string, Record> records;
+
+    public:
+        /// @brief Read the manifest of `directory`
+        /// @return Manifest with no records if there is none or it cannot be read
+        static DeployManifest Load(const std::filesystem::path& directory);
+
+        /// @brief Replace the manifest of `directory` with this one
+        void Save(const std::filesystem::path& directory) const;
+
+        /// @brief Make a record of the mod file `modFile` with its checksum, if it is known
+        /// @return `std::nullopt` if the file cannot be stat'ed
+        static std::optional<Record> MakeRecord(const std::filesystem::path& modFile, std::optional<uint64_t> checksum, 
+            PackIndex::ChecksumAlgorithm checksumAlgorithm);
+
+        /// @brief Check whether `modFile` still matches `record`
+        static bool Matches(const std::filesystem::path& modFile, const Record& record);
+
+        std::optional<Record> Find(std::u32string_view name) const;
+        void Set(std::u32string_view name, const Record& record);
+        void Remove(std::u32string_view name);
+
+        std::map<std::u32string, Record>::const_iterator begin() const;
+        std::map<std::u32string, Record>::const_iterator end() const;
+    };
+}
+
+#endif //DEPLOY_MANIFEST_HPP
\ No newline at end of file
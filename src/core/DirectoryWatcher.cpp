@@ -0,0 +1,212 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include <iomanip>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <boost/format.hpp>
+#include "DirectoryWatcher.hpp"
+
+using boost::format;
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr uint32_t WatchedEvents = IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    /// @brief Events of the parent directory which may bring the watched directory back
+    constexpr uint32_t ParentEvents = IN_CREATE | IN_MOVED_TO;
+
+    /// @brief `directory` without a trailing separator, so its parent and name are the expected ones
+    fs::path WithoutTrailingSeparator(const fs::path& directory)
+    {
+        const auto normal = directory.lexically_normal();
+        return normal.has_filename() ? normal : normal.parent_path();
+    }
+
+    fs::path GetParent(const fs::path& directory)
+    {
+        const auto parent = WithoutTrailingSeparator(directory).parent_path();
+        return parent.empty() ? fs::path(".") : parent;
+    }
+}
+
+MCPacker::DirectoryWatcher::DirectoryWatcher(fs::path directory)
+    :
+    directory(std::move(directory)),
+    inotifyFd(inotify_init1(IN_CLOEXEC | IN_NONBLOCK)),
+    directoryWatch(-1),
+    parentWatch(-1),
+    stopFd(-1),
+    thread()
+{
+    if (inotifyFd == -1)
+    {
+        throw std::runtime_error((format("Unable to initialise inotify: %1%") % std::strerror(errno)).str());
+    }
+
+    directoryWatch = inotify_add_watch(inotifyFd, this->directory.c_str(), WatchedEvents | IN_ONLYDIR);
+    if (directoryWatch == -1)
+    {
+        const auto message = format("Unable to watch directory %1%: %2%") % std::quoted(this->directory.string()) % std::strerror(errno);
+        close(inotifyFd);
+        throw std::runtime_error(message.str());
+    }
+
+    stopFd = eventfd(0, EFD_CLOEXEC);
+    if (stopFd == -1)
+    {
+        const auto message = format("Unable to create eventfd: %1%") % std::strerror(errno);
+        close(inotifyFd);
+        throw std::runtime_error(message.str());
+    }
+}
+
+MCPacker::DirectoryWatcher::~DirectoryWatcher()
+{
+    const uint64_t stop = 1;
+    [[maybe_unused]] const auto written = write(stopFd, &stop, sizeof(stop));
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+    close(stopFd);
+    close(inotifyFd);
+}
+
+void MCPacker::DirectoryWatcher::Start(Listener listener)
+{
+    if (thread.joinable())
+    {
+        throw std::logic_error("Watcher is already started!");
+    }
+
+    thread = std::jthread(
+        [this, listener = std::move(listener)]()
+        {
+            Watch(listener);
+        });
+}
+
+void MCPacker::DirectoryWatcher::LoseDirectory()
+{
+    directoryWatch = -1;
+    if (parentWatch == -1)
+    {
+        // Without the parent there is nothing to wait in, the directory stays unwatched
+        parentWatch = inotify_add_watch(inotifyFd, GetParent(directory).c_str(), ParentEvents | IN_ONLYDIR);
+    }
+
+    // The directory may have come back before its parent was watched
+    RestoreDirectory();
+}
+
+bool MCPacker::DirectoryWatcher::RestoreDirectory()
+{
+    directoryWatch = inotify_add_watch(inotifyFd, directory.c_str(), WatchedEvents | IN_ONLYDIR);
+    if (directoryWatch == -1)
+    {
+        return false;
+    }
+
+    if (parentWatch != -1)
+    {
+        inotify_rm_watch(inotifyFd, parentWatch);
+        parentWatch = -1;
+    }
+    return true;
+}
+
+void MCPacker::DirectoryWatcher::Watch(const Listener& listener)
+{
+    const auto directoryName = WithoutTrailingSeparator(directory).filename();
+    alignas(inotify_event) std::array<char, 16 * 1024> buffer;
+    std::array<pollfd, 2> fds = {pollfd{.fd = inotifyFd, .events = POLLIN, .revents = 0}, pollfd{.fd = stopFd, .events = POLLIN, .revents = 0}};
+
+    while (true)
+    {
+        if (poll(fds.data(), fds.size(), -1) == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return;
+        }
+        if (fds[1].revents != 0)
+        {
+            return;
+        }
+
+        std::vector<fs::path> changed;
+        bool rescan = false;
+
+        // Drain everything queued so far, so a burst of changes is reported at once
+        while (true)
+        {
+            const auto length = read(inotifyFd, buffer.data(), buffer.size());
+            if (length <= 0)
+            {
+                break;
+            }
+
+            for (auto cursor = buffer.data(); cursor < buffer.data() + length; )
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(cursor);
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    rescan = true;
+                }
+                else if (event->wd == directoryWatch and event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+                {
+                    // A directory moved away is still watched, but it is not at `directory` anymore
+                    if (event->mask & IN_MOVE_SELF)
+                    {
+                        inotify_rm_watch(inotifyFd, directoryWatch);
+                    }
+                    LoseDirectory();
+                    rescan = true;
+                }
+                else if (event->wd == directoryWatch)
+                {
+                    if (event->len != 0 and not (event->mask & IN_ISDIR))
+                    {
+                        changed.push_back(directory / event->name);
+                    }
+                }
+                else if (event->wd == parentWatch and event->len != 0 and event->mask & IN_ISDIR 
+                    and directoryName == event->name)
+                {
+                    // Files may have been put into the directory before it was watched
+                    rescan = RestoreDirectory() or rescan;
+                }
+                cursor += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        if (not changed.empty() or rescan)
+        {
+            listener(changed, rescan);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIRECTORY_WATCHER_HPP
+#define DIRECTORY_WATCHER_HPP
+
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace MCPacker
+{
+    /// @brief Reports files of a directory which were written, replaced or removed
+    /// @details Changes are picked up with inotify on a background thread. Files count as written
+    /// once they are closed after writing or moved into the directory, so half-written files are not reported.
+    /// Changes are recorded from the moment the watcher is constructed, so none are missed between
+    /// listing the directory and starting the watcher. If the directory is removed or moved away,
+    /// the watcher waits in its parent for a directory of the same name and watches that one from then on
+    class DirectoryWatcher final : private boost::noncopyable
+    {
+    public:
+        /// @brief Called on the watcher's thread with the paths of the changed files.
+        /// `rescan` is set if every file may have changed: the kernel dropped some events,
+        /// or the directory was removed, moved away or came back. The listener must not throw
+        using Listener = std::function<void(const std::vector<std::filesystem::path>& changed, bool rescan)>;
+
+    private:
+        std::filesystem::path directory;
+        int inotifyFd;
+
+        /// @brief Watch descriptor of the directory, -1 while it is gone
+        int directoryWatch;
+
+        /// @brief Watch descriptor of the parent directory while waiting for the directory to come back, -1 otherwise
+        int parentWatch;
+
+        /// @brief `eventfd` waking the thread up when the watcher is destroyed
+        int stopFd;
+        std::jthread thread;
+
+        /// @brief Stop watching the directory and wait for it in its parent
+        void LoseDirectory();
+
+        /// @brief Watch the directory again if it is back
+        /// @return Whether it is watched now
+        bool RestoreDirectory();
+
+        void Watch(const Listener& listener);
+
+    public:
+        /// @brief Start recording changes of `directory`
+        /// @throws std::runtime_error if the directory cannot be watched
+        DirectoryWatcher(std::filesystem::path directory);
+        ~DirectoryWatcher();
+
+        /// @brief Start reporting changes to `listener`, including the ones made since construction
+        void Start(Listener listener);
+    };
+}
+
+#endif //DIRECTORY_WATCHER_HPP
\ No newline at end of file
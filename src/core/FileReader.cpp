@@ -0,0 +1,205 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/format.hpp>
+#include "FileReader.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+MCPacker::ReadOptions::ReadOptions()
+    :
+    ReadOptions(0)
+{
+
+}
+
+MCPacker::ReadOptions::ReadOptions(uint64_t directThreshold)
+    :
+    directThreshold(directThreshold)
+{
+
+}
+
+MCPacker::FileReader::FileReader(fs::path path, const ReadOptions& options)
+    :
+    path(std::move(path)),
+    fd(-1),
+    size(0),
+    direct(false)
+{
+    fd = open(this->path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        if (errno == ENOENT)
+        {
+            const auto message = format("File %1% does not exist!") % std::quoted(this->path.string());
+            throw std::invalid_argument(message.str());
+        }
+        const auto message = format("Unable to open file %1%: %2%") % std::quoted(this->path.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) == -1)
+    {
+        const auto message = format("Unable to stat file %1%: %2%") % std::quoted(this->path.string()) % std::strerror(errno);
+        close(fd);
+        throw std::runtime_error(message.str());
+    }
+    if (not S_ISREG(status.st_mode))
+    {
+        const auto message = format("File %1% is not a regular file!") % std::quoted(this->path.string());
+        close(fd);
+        throw std::invalid_argument(message.str());
+    }
+    size = static_cast<uint64_t>(status.st_size);
+
+    // The flag is switched on the open descriptor, file systems which do not support it refuse it right away
+    if (options.directThreshold != 0 and size >= options.directThreshold)
+    {
+        direct = fcntl(fd, F_SETFL, O_DIRECT) != -1;
+    }
+    if (not direct)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+}
+
+MCPacker::FileReader::~FileReader()
+{
+    if (fd != -1)
+    {
+        close(fd);
+    }
+}
+
+const fs::path& MCPacker::FileReader::GetPath() const
+{
+    return path;
+}
+
+uint64_t MCPacker::FileReader::GetSize() const
+{
+    return size;
+}
+
+size_t MCPacker::FileReader::ReadBuffered(std::span<Byte> destination, uint64_t offset)
+{
+    size_t total = 0;
+    while (total < destination.size())
+    {
+        const auto count = pread(fd, destination.data() + total, destination.size() - total, static_cast<off_t>(offset + total));
+        if (count == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            const auto message = format("Unable to read file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+            throw std::runtime_error(message.str());
+        }
+        if (count == 0)
+        {
+            break;
+        }
+        total += static_cast<size_t>(count);
+    }
+    return total;
+}
+
+size_t MCPacker::FileReader::ReadDirect(std::span<Byte> destination)
+{
+    // Smaller files only need a buffer of their size rounded up to whole blocks
+    const auto chunkSize = static_cast<size_t>(std::clamp<uint64_t>((size + Alignment - 1) / Alignment * Alignment, Alignment, DirectChunkSize));
+    const std::unique_ptr<Byte, decltype(&std::free)> buffer(
+        static_cast<Byte*>(std::aligned_alloc(Alignment, chunkSize)), &std::free);
+    if (buffer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    // Offsets and lengths stay multiples of the alignment as long as every read is complete,
+    // the last one asks for a whole chunk and gets only what is left of the file
+    size_t total = 0;
+    while (total < destination.size())
+    {
+        const auto count = pread(fd, buffer.get(), chunkSize, static_cast<off_t>(total));
+        if (count == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EINVAL)
+            {
+                DisableDirect();
+                return total + ReadBuffered(destination.subspan(total), total);
+            }
+            const auto message = format("Unable to read file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+            throw std::runtime_error(message.str());
+        }
+        if (count == 0)
+        {
+            break;
+        }
+
+        const auto used = std::min(static_cast<size_t>(count), destination.size() - total);
+        std::memcpy(destination.data() + total, buffer.get(), used);
+        total += used;
+        if (static_cast<size_t>(count) % Alignment != 0 and total < destination.size())
+        {
+            // A short read in the middle of the file leaves the offset unaligned
+            DisableDirect();
+            return total + ReadBuffered(destination.subspan(total), total);
+        }
+    }
+    return total;
+}
+
+void MCPacker::FileReader::DisableDirect()
+{
+    direct = false;
+    fcntl(fd, F_SETFL, 0);
+}
+
+size_t MCPacker::FileReader::Read(std::span<Byte> destination)
+{
+    if (direct)
+    {
+        return ReadDirect(destination);
+    }
+    return ReadBuffered(destination, 0);
+}
+
+std::vector<Byte> MCPacker::FileReader::ReadAll()
+{
+    std::vector<Byte> data(size);
+    data.resize(Read(data));
+    return data;
+}
\ No newline at end of file
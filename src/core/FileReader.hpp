@@ -0,0 +1,87 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FILE_READER_HPP
+#define FILE_READER_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <Utility.hpp>
+
+namespace MCPacker
+{
+    /// @brief How whole files are read into memory
+    struct ReadOptions
+    {
+        /// @brief Files at least this large are read with `O_DIRECT`, bypassing the page cache,
+        /// `0` disables it. Huge jars read once then only evict whatever else is cached
+        uint64_t directThreshold;
+
+        ReadOptions();
+        ReadOptions(uint64_t directThreshold);
+    };
+
+    /// @brief Reads a whole file with one `open`, one `fstat` and reads as large as the file
+    /// @details Where `O_DIRECT` is requested but the file system does not support it,
+    /// the file is read through the page cache instead
+    class FileReader final : private boost::noncopyable
+    {
+    public:
+        static constexpr size_t Alignment = 4096;
+
+        /// @brief Size of the aligned buffer `O_DIRECT` reads go through
+        static constexpr size_t DirectChunkSize = 8 << 20;
+
+    private:
+        std::filesystem::path path;
+        int fd;
+        uint64_t size;
+        bool direct;
+
+        /// @brief Read into `destination` from `offset` on, return the number of bytes read
+        size_t ReadBuffered(std::span<Utility::Definitions::Byte> destination, uint64_t offset);
+        size_t ReadDirect(std::span<Utility::Definitions::Byte> destination);
+
+        /// @brief Continue reading through the page cache
+        void DisableDirect();
+
+    public:
+        /// @brief Open `path` for reading
+        /// @throws std::invalid_argument if the path does not exist or is not a regular file
+        /// @throws std::runtime_error if the file cannot be opened
+        FileReader(std::filesystem::path path, const ReadOptions& options = ReadOptions());
+        ~FileReader();
+
+        const std::filesystem::path& GetPath() const;
+
+        /// @brief Size of the file when it was opened
+        uint64_t GetSize() const;
+
+        /// @brief Read the file from its beginning into `destination`
+        /// @return Number of bytes read, less than the destination's size only if the file ends earlier
+        /// @throws std::runtime_error if the file cannot be read
+        size_t Read(std::span<Utility::Definitions::Byte> destination);
+
+        /// @brief Read the whole file into a buffer of its size
+        std::vector<Utility::Definitions::Byte> ReadAll();
+    };
+}
+
+#endif //FILE_READER_HPP
\ No newline at end of file
@@ -0,0 +1,638 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <iomanip>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <boost/format.hpp>
+#include "IoRing.hpp"
+#include "OrderedHandOff.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    /// @brief Kinds of operations a file goes through, a completion's tag is the file's index and the kind
+    enum Operation : uint64_t
+    {
+        Status,
+        Open,
+        Transfer,
+
+        /// @brief Reading the data to write from another file
+        Fetch,
+        Close,
+        OperationCount
+    };
+
+    uint64_t MakeTag(size_t file, Operation operation)
+    {
+        return static_cast<uint64_t>(file) * OperationCount + operation;
+    }
+
+    template<typename T>
+    T LoadAcquire(T* value)
+    {
+        return std::atomic_ref(*value).load(std::memory_order_acquire);
+    }
+
+    template<typename T>
+    void StoreRelease(T* value, T newValue)
+    {
+        std::atomic_ref(*value).store(newValue, std::memory_order_release);
+    }
+
+    /// @brief Error of opening or inspecting a file to read, a missing file is the caller's mistake
+    std::exception_ptr MakeOpenError(const char* action, const fs::path& path, int error)
+    {
+        if (error == ENOENT)
+        {
+            const auto message = format("File %1% does not exist!") % std::quoted(path.string());
+            return std::make_exception_ptr(std::invalid_argument(message.str()));
+        }
+        const auto message = format("Unable to %1% file %2%: %3%") % action % std::quoted(path.string()) % std::strerror(error);
+        return std::make_exception_ptr(std::runtime_error(message.str()));
+    }
+
+    std::exception_ptr MakeError(const char* action, const fs::path& path, int error)
+    {
+        const auto message = format("Unable to %1% file %2%: %3%") % action % std::quoted(path.string()) % std::strerror(error);
+        return std::make_exception_ptr(std::runtime_error(message.str()));
+    }
+}
+
+MCPacker::IoRing::IoRing(unsigned entries)
+    :
+    ringFd(-1),
+    params(),
+    submissionRing(MAP_FAILED),
+    submissionRingSize(0),
+    completionRing(MAP_FAILED),
+    completionRingSize(0),
+    entries(static_cast<io_uring_sqe*>(MAP_FAILED)),
+    submissionHead(nullptr),
+    submissionTail(nullptr),
+    submissionMask(0),
+    submissionArray(nullptr),
+    completionHead(nullptr),
+    completionTail(nullptr),
+    completionMask(0),
+    completions(nullptr),
+    queued(0),
+    inFlight(0),
+    reaped()
+{
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd == -1)
+    {
+        throw std::runtime_error((format("Unable to set up io_uring: %1%") % std::strerror(errno)).str());
+    }
+
+    submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMapping)
+    {
+        submissionRingSize = completionRingSize = std::max(submissionRingSize, completionRingSize);
+    }
+
+    submissionRing = mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    completionRing = singleMapping
+        ? submissionRing
+        : mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    this->entries = static_cast<io_uring_sqe*>(mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+    if (submissionRing == MAP_FAILED or completionRing == MAP_FAILED or this->entries == MAP_FAILED)
+    {
+        const auto message = format("Unable to map io_uring queues: %1%") % std::strerror(errno);
+        Release();
+        throw std::runtime_error(message.str());
+    }
+
+    auto* submission = static_cast<Byte*>(submissionRing);
+    submissionHead = reinterpret_cast<unsigned*>(submission + params.sq_off.head);
+    submissionTail = reinterpret_cast<unsigned*>(submission + params.sq_off.tail);
+    submissionMask = *reinterpret_cast<unsigned*>(submission + params.sq_off.ring_mask);
+    submissionArray = reinterpret_cast<unsigned*>(submission + params.sq_off.array);
+
+    auto* completion = static_cast<Byte*>(completionRing);
+    completionHead = reinterpret_cast<unsigned*>(completion + params.cq_off.head);
+    completionTail = reinterpret_cast<unsigned*>(completion + params.cq_off.tail);
+    completionMask = *reinterpret_cast<unsigned*>(completion + params.cq_off.ring_mask);
+    completions = reinterpret_cast<io_uring_cqe*>(completion + params.cq_off.cqes);
+
+    reaped.reserve(params.cq_entries);
+}
+
+MCPacker::IoRing::~IoRing()
+{
+    Release();
+}
+
+void MCPacker::IoRing::Release()
+{
+    if (entries != MAP_FAILED)
+    {
+        munmap(entries, params.sq_entries * sizeof(io_uring_sqe));
+    }
+    if (completionRing != MAP_FAILED and completionRing != submissionRing)
+    {
+        munmap(completionRing, completionRingSize);
+    }
+    if (submissionRing != MAP_FAILED)
+    {
+        munmap(submissionRing, submissionRingSize);
+    }
+    if (ringFd != -1)
+    {
+        close(ringFd);
+    }
+    entries = static_cast<io_uring_sqe*>(MAP_FAILED);
+    completionRing = submissionRing = MAP_FAILED;
+    ringFd = -1;
+}
+
+bool MCPacker::IoRing::IsSupported()
+{
+    static const bool supported = []()
+    {
+        try
+        {
+            const IoRing ring(8);
+            return std::ranges::all_of(std::initializer_list<uint8_t>{IORING_OP_STATX, IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE},
+                [&ring](uint8_t opcode)
+                {
+                    return ring.Supports(opcode);
+                });
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+    }();
+    return supported;
+}
+
+bool MCPacker::IoRing::Supports(uint8_t opcode) const
+{
+    constexpr unsigned OperationSlots = 256;
+    std::vector<Byte> buffer(sizeof(io_uring_probe) + OperationSlots * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, OperationSlots) == -1)
+    {
+        return false;
+    }
+    return opcode <= probe->last_op and (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+}
+
+bool MCPacker::IoRing::HasRoom() const
+{
+    return inFlight < params.sq_entries;
+}
+
+unsigned MCPacker::IoRing::GetInFlight() const
+{
+    return inFlight;
+}
+
+io_uring_sqe& MCPacker::IoRing::Prepare(uint8_t opcode, int fd, uint64_t tag)
+{
+    if (not HasRoom())
+    {
+        throw std::logic_error("The io_uring submission queue is full!");
+    }
+
+    // Only this process moves the tail, the kernel moves the head as it consumes the entries
+    const auto tail = *submissionTail;
+    const auto index = tail & submissionMask;
+    auto& entry = entries[index];
+    std::memset(&entry, 0, sizeof(entry));
+    entry.opcode = opcode;
+    entry.fd = fd;
+    entry.user_data = tag;
+    submissionArray[index] = index;
+    StoreRelease(submissionTail, tail + 1);
+
+    ++queued;
+    ++inFlight;
+    return entry;
+}
+
+void MCPacker::IoRing::QueueOpen(const fs::path& path, int flags, mode_t mode, uint64_t tag)
+{
+    auto& entry = Prepare(IORING_OP_OPENAT, AT_FDCWD, tag);
+    entry.addr = reinterpret_cast<uint64_t>(path.c_str());
+    entry.len = mode;
+    entry.open_flags = static_cast<uint32_t>(flags);
+}
+
+void MCPacker::IoRing::QueueStatus(const fs::path& path, struct statx& status, uint64_t tag)
+{
+    auto& entry = Prepare(IORING_OP_STATX, AT_FDCWD, tag);
+    entry.addr = reinterpret_cast<uint64_t>(path.c_str());
+    entry.len = STATX_TYPE | STATX_SIZE;
+    entry.off = reinterpret_cast<uint64_t>(&status);
+}
+
+void MCPacker::IoRing::QueueRead(int fd, std::span<Byte> buffer, uint64_t offset, uint64_t tag)
+{
+    auto& entry = Prepare(IORING_OP_READ, fd, tag);
+    entry.addr = reinterpret_cast<uint64_t>(buffer.data());
+    entry.len = static_cast<uint32_t>(std::min<size_t>(buffer.size(), MaxChunkSize));
+    entry.off = offset;
+}
+
+void MCPacker::IoRing::QueueWrite(int fd, std::span<const Byte> data, uint64_t offset, uint64_t tag)
+{
+    auto& entry = Prepare(IORING_OP_WRITE, fd, tag);
+    entry.addr = reinterpret_cast<uint64_t>(data.data());
+    entry.len = static_cast<uint32_t>(std::min<size_t>(data.size(), MaxChunkSize));
+    entry.off = offset;
+}
+
+void MCPacker::IoRing::QueueClose(int fd, uint64_t tag)
+{
+    Prepare(IORING_OP_CLOSE, fd, tag);
+}
+
+void MCPacker::IoRing::Reap()
+{
+    // Only this process moves the head, the kernel moves the tail as operations complete
+    auto head = *completionHead;
+    const auto tail = LoadAcquire(completionTail);
+    for (; head != tail; ++head)
+    {
+        const auto& completion = completions[head & completionMask];
+        reaped.push_back(Completion{.tag = completion.user_data, .result = completion.res});
+        --inFlight;
+    }
+    StoreRelease(completionHead, head);
+}
+
+std::span<const MCPacker::IoRing::Completion> MCPacker::IoRing::SubmitAndWait()
+{
+    reaped.clear();
+    if (inFlight == 0)
+    {
+        return reaped;
+    }
+
+    while (true)
+    {
+        const auto submitted = syscall(__NR_io_uring_enter, ringFd, queued, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (submitted == -1)
+        {
+            // The queues are left as they were, operations which could not be submitted are retried
+            if (errno == EINTR or errno == EAGAIN or errno == EBUSY)
+            {
+                Reap();
+                if (not reaped.empty())
+                {
+                    return reaped;
+                }
+                continue;
+            }
+            throw std::runtime_error((format("Unable to submit io_uring operations: %1%") % std::strerror(errno)).str());
+        }
+        queued -= static_cast<unsigned>(submitted);
+
+        Reap();
+        if (not reaped.empty())
+        {
+            return reaped;
+        }
+    }
+}
+
+void MCPacker::IoRing::WriteFiles(std::span<const FileWrite> files, const WriteListener& written)
+{
+    struct State
+    {
+        int fd = -1;
+        uint64_t offset = 0;
+
+        /// @brief Chunk of the source being written and the offset in the file it starts at
+        std::vector<Byte> buffer;
+        uint64_t bufferOffset = 0;
+    };
+    std::vector<State> states(files.size());
+    size_t nextToOpen = 0;
+    std::exception_ptr firstError;
+
+    // Every file has at most one operation in flight, the one finishing makes room for the next
+    const auto continueWriting = [&](size_t file)
+    {
+        const auto& write = files[file];
+        auto& state = states[file];
+        const auto size = write.source.has_value() ? write.source->size : write.data.size();
+        if (state.offset == size or firstError)
+        {
+            QueueClose(state.fd, MakeTag(file, Close));
+            return;
+        }
+        if (not write.source.has_value())
+        {
+            QueueWrite(state.fd, write.data.subspan(static_cast<size_t>(state.offset)), state.offset, MakeTag(file, Transfer));
+            return;
+        }
+
+        // A chunk of the source is fetched once the previous one is written
+        const auto written = static_cast<size_t>(state.offset - state.bufferOffset);
+        if (written == state.buffer.size())
+        {
+            state.bufferOffset = state.offset;
+            state.buffer.resize(static_cast<size_t>(std::min<uint64_t>(size - state.offset, CopyChunkSize)));
+            QueueRead(write.source->fd, state.buffer, write.source->offset + state.offset, MakeTag(file, Fetch));
+            return;
+        }
+        QueueWrite(state.fd, std::span(state.buffer).subspan(written), state.offset, MakeTag(file, Transfer));
+    };
+
+    while (true)
+    {
+        for (; not firstError and nextToOpen < files.size() and HasRoom(); ++nextToOpen)
+        {
+            QueueOpen(files[nextToOpen].path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644, MakeTag(nextToOpen, Open));
+        }
+        if (inFlight == 0)
+        {
+            break;
+        }
+
+        for (const auto& completion : SubmitAndWait())
+        {
+            const auto file = static_cast<size_t>(completion.tag / OperationCount);
+            auto& state = states[file];
+            switch (completion.tag % OperationCount)
+            {
+                case Open:
+                    if (completion.result < 0)
+                    {
+                        if (not firstError)
+                        {
+                            firstError = MakeError("create", files[file].path, -completion.result);
+                        }
+                        break;
+                    }
+                    state.fd = completion.result;
+                    continueWriting(file);
+                    break;
+
+                case Transfer:
+                    // Only data left to write is queued, so writing nothing would repeat the write forever
+                    if (completion.result <= 0 and not firstError)
+                    {
+                        firstError = MakeError("write", files[file].path, completion.result == 0 ? EIO : -completion.result);
+                    }
+                    state.offset += static_cast<uint64_t>(std::max(completion.result, 0));
+                    continueWriting(file);
+                    break;
+
+                case Fetch:
+                    if (completion.result <= 0 and not firstError)
+                    {
+                        const auto message = completion.result == 0
+                            ? format("Unexpected end of the data to write into file %1%!") % std::quoted(files[file].path.string())
+                            : format("Unable to read the data to write into file %1%: %2%") % std::quoted(files[file].path.string()) 
+                                % std::strerror(-completion.result);
+                        firstError = std::make_exception_ptr(std::runtime_error(message.str()));
+                    }
+                    state.buffer.resize(static_cast<size_t>(std::max(completion.result, 0)));
+                    continueWriting(file);
+                    break;
+
+                case Close:
+                    state.fd = -1;
+                    state.buffer = std::vector<Byte>();
+                    if (completion.result < 0 and not firstError)
+                    {
+                        firstError = MakeError("write", files[file].path, -completion.result);
+                    }
+                    if (not firstError)
+                    {
+                        try
+                        {
+                            written(file);
+                        }
+                        catch (...)
+                        {
+                            firstError = std::current_exception();
+                        }
+                    }
+                    break;
+            }
+        }
+    }
+
+    if (firstError)
+    {
+        std::rethrow_exception(firstError);
+    }
+}
+
+void MCPacker::IoRing::ReadFiles(std::span<const fs::path> paths, uint64_t maxBytesInFlight, const ReadListener& read)
+{
+    struct State
+    {
+        int fd = -1;
+        struct statx status = {};
+
+        /// @brief Operations of opening the file still in flight
+        unsigned opening = 0;
+        bool failed = false;
+        bool finished = false;
+        std::vector<Byte> data;
+        uint64_t offset = 0;
+    };
+    std::vector<State> states(paths.size());
+
+    // Files are inspected and opened together, so each one may have two operations in flight
+    const size_t maxOpenFiles = std::max(1u, params.sq_entries / 2);
+    size_t openFiles = 0;
+    size_t nextToOpen = 0;
+
+    // The budget is taken by the size a file had when it was inspected, the data may turn out shorter if it shrinks
+    OrderedHandOff<std::vector<Byte>> handOff(paths.size(), maxBytesInFlight);
+    std::set<size_t> waiting;
+    std::exception_ptr firstError;
+
+    const auto fail = [&](std::exception_ptr error)
+    {
+        if (not firstError)
+        {
+            firstError = std::move(error);
+        }
+    };
+
+    const auto pass = [&](size_t file, std::vector<Byte> data)
+    {
+        if (firstError)
+        {
+            return;
+        }
+        try
+        {
+            read(file, std::move(data));
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+    };
+
+    const auto continueReading = [&](size_t file)
+    {
+        auto& state = states[file];
+        if (state.offset == state.data.size() or firstError)
+        {
+            state.finished = state.offset == state.data.size();
+            QueueClose(state.fd, MakeTag(file, Close));
+            return;
+        }
+        QueueRead(state.fd, std::span(state.data).subspan(static_cast<size_t>(state.offset)), state.offset, MakeTag(file, Transfer));
+    };
+
+    while (true)
+    {
+        for (; not firstError and nextToOpen < paths.size() and openFiles < maxOpenFiles; ++nextToOpen, ++openFiles)
+        {
+            states[nextToOpen].opening = 2;
+            QueueStatus(paths[nextToOpen], states[nextToOpen].status, MakeTag(nextToOpen, Status));
+            QueueOpen(paths[nextToOpen], O_RDONLY | O_CLOEXEC, 0, MakeTag(nextToOpen, Open));
+        }
+        if (inFlight == 0)
+        {
+            break;
+        }
+
+        for (const auto& completion : SubmitAndWait())
+        {
+            const auto file = static_cast<size_t>(completion.tag / OperationCount);
+            auto& state = states[file];
+            switch (completion.tag % OperationCount)
+            {
+                case Status:
+                    if (completion.result < 0)
+                    {
+                        fail(MakeOpenError("stat", paths[file], -completion.result));
+                        state.failed = true;
+                    }
+                    else if (not S_ISREG(state.status.stx_mode))
+                    {
+                        const auto message = format("File %1% is not a regular file!") % std::quoted(paths[file].string());
+                        fail(std::make_exception_ptr(std::invalid_argument(message.str())));
+                        state.failed = true;
+                    }
+                    break;
+
+                case Open:
+                    if (completion.result < 0)
+                    {
+                        fail(MakeOpenError("open", paths[file], -completion.result));
+                        state.failed = true;
+                    }
+                    else
+                    {
+                        state.fd = completion.result;
+                    }
+                    break;
+
+                case Transfer:
+                    if (completion.result < 0)
+                    {
+                        fail(MakeError("read", paths[file], -completion.result));
+                        QueueClose(state.fd, MakeTag(file, Close));
+                        break;
+                    }
+                    if (completion.result == 0)
+                    {
+                        // The file got shorter since it was inspected
+                        state.data.resize(static_cast<size_t>(state.offset));
+                    }
+                    state.offset += static_cast<uint64_t>(completion.result);
+                    continueReading(file);
+                    break;
+
+                case Close:
+                    state.fd = -1;
+                    --openFiles;
+                    if (state.finished and not firstError)
+                    {
+                        handOff.Finish(file, std::move(state.data), pass);
+                    }
+                    break;
+            }
+
+            const auto operation = completion.tag % OperationCount;
+            if ((operation == Status or operation == Open) and --state.opening == 0)
+            {
+                if (state.fd == -1)
+                {
+                    --openFiles;
+                }
+                else if (state.failed or firstError)
+                {
+                    QueueClose(state.fd, MakeTag(file, Close));
+                }
+                else
+                {
+                    waiting.insert(file);
+                }
+            }
+        }
+
+        for (auto i = std::begin(waiting); i != std::end(waiting); )
+        {
+            auto& state = states[*i];
+            const auto size = static_cast<uint64_t>(state.status.stx_size);
+            if (firstError)
+            {
+                QueueClose(state.fd, MakeTag(*i, Close));
+            }
+            else if (handOff.CanAdmit(*i, size))
+            {
+                handOff.Admit(*i, size);
+                state.data.resize(static_cast<size_t>(size));
+                continueReading(*i);
+            }
+            else
+            {
+                ++i;
+                continue;
+            }
+            i = waiting.erase(i);
+        }
+    }
+
+    if (firstError)
+    {
+        std::rethrow_exception(firstError);
+    }
+}
\ No newline at end of file
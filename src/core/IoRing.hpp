@@ -0,0 +1,167 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IO_RING_HPP
+#define IO_RING_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+#include <linux/io_uring.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <boost/noncopyable.hpp>
+#include <Utility.hpp>
+
+namespace MCPacker
+{
+    /// @brief Submission and completion queues of `io_uring`, used to create, read and write many files
+    /// with a handful of system calls
+    /// @details The ring is set up with the raw system calls, so it does not need liburing. Whether the kernel
+    /// supports it, and the operations used here, is only known at run time, see `IsSupported`.
+    /// A ring is used by one thread at a time
+    class IoRing final : private boost::noncopyable
+    {
+    public:
+        static constexpr unsigned DefaultEntries = 256;
+
+        /// @brief Largest amount of bytes a single read or write asks for
+        static constexpr uint32_t MaxChunkSize = 1 << 30;
+
+        /// @brief Size of the buffer each file copied from another one goes through
+        static constexpr size_t CopyChunkSize = 128 << 10;
+
+        struct Completion
+        {
+            uint64_t tag;
+
+            /// @brief Result of the operation as the system call would return it, or `-errno`
+            int result;
+        };
+
+        /// @brief Range of an open file
+        struct FileRange
+        {
+            int fd;
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        struct FileWrite
+        {
+            std::filesystem::path path;
+
+            /// @brief Data to write, unless `source` is set
+            std::span<const Utility::Definitions::Byte> data;
+
+            /// @brief Range to copy into the file instead of `data`, it goes through a buffer of `CopyChunkSize` bytes
+            std::optional<FileRange> source;
+        };
+
+        /// @brief Called with the index of a file once it is written and closed
+        using WriteListener = std::function<void(size_t file)>;
+
+        /// @brief Called with the index of a file and its whole content
+        using ReadListener = std::function<void(size_t file, std::vector<Utility::Definitions::Byte> data)>;
+
+    private:
+        int ringFd;
+        io_uring_params params;
+
+        void* submissionRing;
+        size_t submissionRingSize;
+        void* completionRing;
+        size_t completionRingSize;
+        io_uring_sqe* entries;
+
+        unsigned* submissionHead;
+        unsigned* submissionTail;
+        unsigned submissionMask;
+        unsigned* submissionArray;
+        unsigned* completionHead;
+        unsigned* completionTail;
+        unsigned completionMask;
+        io_uring_cqe* completions;
+
+        /// @brief Operations queued but not submitted yet
+        unsigned queued;
+
+        /// @brief Operations queued or submitted whose completion has not been reaped yet
+        unsigned inFlight;
+
+        std::vector<Completion> reaped;
+
+        /// @brief Unmap the queues and close the ring
+        void Release();
+
+        /// @brief Take the next free submission queue entry, cleared
+        io_uring_sqe& Prepare(uint8_t opcode, int fd, uint64_t tag);
+
+        /// @brief Move every available completion into `reaped`
+        void Reap();
+
+    public:
+        /// @brief Set up a ring with room for `entries` operations in flight
+        /// @throws std::runtime_error if the kernel does not support `io_uring` or forbids it
+        IoRing(unsigned entries = DefaultEntries);
+        ~IoRing();
+
+        /// @brief Check once per process whether rings can be set up and support every operation used here
+        static bool IsSupported();
+
+        /// @brief Whether the kernel supports operation `opcode` on this ring
+        bool Supports(uint8_t opcode) const;
+
+        /// @brief Whether another operation can be queued without overflowing the ring
+        bool HasRoom() const;
+        unsigned GetInFlight() const;
+
+        /// @param path It must stay alive until the operation completes
+        void QueueOpen(const std::filesystem::path& path, int flags, mode_t mode, uint64_t tag);
+
+        /// @param path It must stay alive, and `status` writable, until the operation completes
+        void QueueStatus(const std::filesystem::path& path, struct statx& status, uint64_t tag);
+        void QueueRead(int fd, std::span<Utility::Definitions::Byte> buffer, uint64_t offset, uint64_t tag);
+        void QueueWrite(int fd, std::span<const Utility::Definitions::Byte> data, uint64_t offset, uint64_t tag);
+        void QueueClose(int fd, uint64_t tag);
+
+        /// @brief Submit the queued operations and wait until at least one operation completes,
+        /// unless none is in flight
+        /// @return Completions reaped by this call, valid until the next one
+        /// @throws std::runtime_error if the operations cannot be submitted
+        std::span<const Completion> SubmitAndWait();
+
+        /// @brief Create every file, truncating existing ones, and write its data
+        /// @details Once a file fails, no new file is created, the operations in flight are waited for
+        /// and the first error is rethrown. Files written up to then are left in place
+        /// @throws std::runtime_error if any file cannot be created or written, or its source cannot be read whole
+        void WriteFiles(std::span<const FileWrite> files, const WriteListener& written);
+
+        /// @brief Read every file at `paths` whole
+        /// @details Files are read concurrently, but `read` is called in the order of `paths`.
+        /// Files which are being read or wait for earlier files take `maxBytesInFlight` bytes at most,
+        /// see `OrderedHandOff`. Once a file fails or `read` throws, no new file is read and the first error is rethrown
+        /// @throws std::invalid_argument if a path does not exist or is not a regular file
+        /// @throws std::runtime_error if a file cannot be read
+        void ReadFiles(std::span<const std::filesystem::path> paths, uint64_t maxBytesInFlight, const ReadListener& read);
+    };
+}
+
+#endif //IO_RING_HPP
\ No newline at end of file
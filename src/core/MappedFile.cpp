@@ -0,0 +1,91 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include <iomanip>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/format.hpp>
+#include "MappedFile.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+
+MCPacker::MappedFile::MappedFile(const std::filesystem::path& path)
+    :
+    address(nullptr),
+    size(0)
+{
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        const auto message = format("Unable to open file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) == -1)
+    {
+        const auto message = format("Unable to stat file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+        close(fd);
+        throw std::runtime_error(message.str());
+    }
+    size = static_cast<size_t>(status.st_size);
+
+    // Zero-length mappings are not allowed, an empty file is just an empty view
+    if (size != 0)
+    {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            const auto message = format("Unable to map file %1%: %2%") % std::quoted(path.string()) % std::strerror(errno);
+            close(fd);
+            throw std::runtime_error(message.str());
+        }
+        address = static_cast<const Byte*>(mapping);
+    }
+
+    // The mapping keeps its own reference to the file
+    close(fd);
+}
+
+MCPacker::MappedFile::~MappedFile()
+{
+    if (address != nullptr)
+    {
+        munmap(const_cast<Byte*>(address), size);
+    }
+}
+
+std::span<const Byte> MCPacker::MappedFile::GetContents() const
+{
+    return std::span<const Byte>(address, size);
+}
+
+std::span<const Byte> MCPacker::MappedFile::GetRange(uint64_t offset, uint64_t length) const
+{
+    if (offset > size or length > size - offset)
+    {
+        const auto message = format("Range [%1%, %2%) is out of the mapped file of size %3%!") % offset % (offset + length) % size;
+        throw std::out_of_range(message.str());
+    }
+    return GetContents().subspan(offset, length);
+}
\ No newline at end of file
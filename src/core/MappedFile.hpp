@@ -0,0 +1,51 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <filesystem>
+#include <span>
+#include <boost/noncopyable.hpp>
+#include <Utility.hpp>
+
+namespace MCPacker
+{
+    /// @brief Read-only memory map of a whole file
+    /// @details The mapping lives as long as the object, so anything viewing
+    /// its contents should share ownership of it
+    class MappedFile final : private boost::noncopyable
+    {
+    private:
+        const Utility::Definitions::Byte* address;
+        size_t size;
+
+    public:
+        /// @brief Map `path` into memory
+        /// @throws std::runtime_error if the file cannot be opened or mapped
+        MappedFile(const std::filesystem::path& path);
+        ~MappedFile();
+
+        std::span<const Utility::Definitions::Byte> GetContents() const;
+
+        /// @brief View `length` bytes starting at `offset`
+        /// @throws std::out_of_range if the range does not lie within the file
+        std::span<const Utility::Definitions::Byte> GetRange(uint64_t offset, uint64_t length) const;
+    };
+}
+
+#endif //MAPPED_FILE_HPP
\ No newline at end of file
@@ -27,57 +27,85 @@
 #include <boost/numeric/conversion/cast.hpp>
 #include "Mod.hpp"
 #include "Utility.hpp"
+#include "PackWriter.hpp"
+#include "FileReader.hpp"
+
+static_assert(MCPacker::Mod::MetaInfo::NameLength == MCPacker::PackIndex::NameLength);
 
 using boost::format;
 using namespace MCPacker::Utility::Definitions;
 namespace fs = std::filesystem;
 
+namespace
+{
+    /// @brief Name a mod read from `pathToJar` gets, in UTF-8 encoding
+    /// @throws std::invalid_argument if the name is too long
+    std::string GetJarName(const fs::path& pathToJar)
+    {
+        const auto fileName = pathToJar.filename().u32string();
+        if (fileName.size() > MCPacker::Mod::MetaInfo::NameLength)
+        {
+            const auto message = format("Name of file %1% is too long!") % std::quoted(pathToJar.filename().string());
+            throw std::invalid_argument(message.str());
+        }
+        return MCPacker::Utility::UTF32ToUTF8(fileName);
+    }
+}
+
 MCPacker::Mod::MetaInfo::MetaInfo() 
     :
-    name()
+    name(),
+    manifest()
 {
-    name.fill(0);
+
 }
 
-MCPacker::Mod::Mod(fs::path pathToJar)
+std::u32string MCPacker::Mod::MetaInfo::GetName() const
+{
+    return Utility::UTF8ToUTF32(name);
+}
+
+MCPacker::Mod::Mod(fs::path pathToJar, const ReadOptions& options)
+    :
+    Mod(FileReader(std::move(pathToJar), options))
+{
+
+}
+
+MCPacker::Mod::Mod(FileReader&& jar)
     :
     metaInfo(),
-    data()
+    data(),
+    mapping(),
+    mappedData()
 {
-    if (not fs::exists(pathToJar))
-    {
-        const auto message = format("File %1% does not exist!") % std::quoted(pathToJar.string());
-        throw std::invalid_argument(message.str());
-    }
+    metaInfo.name = GetJarName(jar.GetPath());
+    data = jar.ReadAll();
+}
 
-    {
-        InputBinaryFile jar(pathToJar, std::ios::binary);
-        if (jar.is_open())
-        {
-            data.reserve(fs::file_size(pathToJar));
-            std::copy(std::istreambuf_iterator(jar), std::istreambuf_iterator<Byte>(),
-                    std::back_inserter(data));
-            std::ranges::copy(pathToJar.filename().u32string(), std::begin(metaInfo.name));
-        }
-        else
-        {
-            const auto message = format("Unable to read file %1%!") % pathToJar.filename().string();
-            throw std::runtime_error(message.str());
-        }
-    }
+MCPacker::Mod::Mod(const fs::path& pathToJar, std::vector<Byte> data)
+    :
+    metaInfo(),
+    data(std::move(data)),
+    mapping(),
+    mappedData()
+{
+    metaInfo.name = GetJarName(pathToJar);
 }
 
 MCPacker::Mod::Mod(InputBinaryFile& pack, Utility::ReadingMode readingMode)
     :
     metaInfo(),
-    data()
+    data(),
+    mapping(),
+    mappedData()
 {
     std::array<Byte, MetaInfo::NameLengthInBytes> name;
     std::array<Byte, sizeof(uint64_t)> dataSizeSerialised;
 
     pack.read(name.data(), name.size());
     pack.read(dataSizeSerialised.data(), dataSizeSerialised.size());
-    metaInfo.name = Utility::FromUTF8Array(name);
+    metaInfo.name = Utility::UTF8ArrayToString(name);
     const auto dataSize = Utility::FromByteArray<uint64_t>(dataSizeSerialised);
 
     switch (readingMode)
@@ -96,21 +124,143 @@ MCPacker::Mod::Mod(InputBinaryFile& pack, Utility::ReadingMode readingMode)
     }
 }
 
-void MCPacker::Mod::WriteToPack(OutputBinaryFile& modPackFile) const
+MCPacker::Mod::Mod(InputBinaryFile& pack, const PackIndex::Entry& entry, Utility::ReadingMode readingMode, const BlobStore* blobStore)
+    :
+    metaInfo(),
+    data(),
+    mapping(),
+    mappedData()
 {
-    const auto dataSize = Utility::ToByteArray(static_cast<uint64_t>(data.size()));
-    const auto name = Utility::ToUTF8Array<MetaInfo::NameLength>(std::u32string_view(std::begin(metaInfo.name), std::end(metaInfo.name)));
+    metaInfo.name = entry.name;
+    metaInfo.manifest = entry.manifest;
+
+    switch (readingMode)
+    {
+        case Utility::ReadingMode::Full:
+        {
+            // Blobs are the mods' data as is
+            InputBinaryFile blob;
+            if (entry.blob.has_value())
+            {
+                blob.open(entry.GetBlobPath(blobStore), std::ios::binary);
+            }
+            auto& source = entry.blob.has_value() ? blob : pack;
+            const uint64_t offset = entry.blob.has_value() ? 0 : entry.offset;
+            const uint64_t storedSize = entry.blob.has_value() ? entry.size : entry.storedSize;
+
+            // The index may be corrupted or crafted, so nothing is allocated for data the file does not hold
+            source.seekg(0, std::ios::end);
+            const auto sourceSize = source.tellg();
+            if (not source)
+            {
+                const auto message = format("Data of mod %1% is truncated!") % metaInfo.name;
+                throw std::runtime_error(message.str());
+            }
+            if (offset > static_cast<uint64_t>(sourceSize) or storedSize > static_cast<uint64_t>(sourceSize) - offset)
+            {
+                const auto message = format("Mod %1% lies outside of the pack!") % metaInfo.name;
+                throw std::runtime_error(message.str());
+            }
+
+            std::vector<Byte> stored(storedSize);
+            source.seekg(boost::numeric_cast<std::remove_cvref_t<decltype(pack)>::off_type>(offset));
+            source.read(stored.data(), stored.size());
+            if (not source)
+            {
+                const auto message = format("Data of mod %1% is truncated!") % metaInfo.name;
+                throw std::runtime_error(message.str());
+            }
 
-    std::copy(std::begin(name), std::end(name), std::ostreambuf_iterator(modPackFile));
-    std::copy(std::begin(dataSize), std::end(dataSize), std::ostreambuf_iterator(modPackFile));
-    std::copy(std::begin(data), std::end(data), std::ostreambuf_iterator(modPackFile));
+            if (entry.codec == Codec::Store or entry.blob.has_value())
+            {
+                data = std::move(stored);
+            }
+            else
+            {
+                data.resize(entry.size);
+                Decompressor::DecompressAll(entry.codec, stored, data);
+            }
+
+            if (entry.checksum.has_value() and *entry.checksum != PackIndex::Checksum(data.data(), data.size(), entry.checksumAlgorithm))
+            {
+                const auto message = format("Checksum mismatch in mod %1%!") % metaInfo.name;
+                throw std::runtime_error(message.str());
+            }
+            break;
+        }
+
+        case Utility::ReadingMode::OnlyMetaInfo:
+            break;
+
+        default:
+            throw std::invalid_argument("Unrecognised reading mode");
+    }
+}
+
+MCPacker::Mod::Mod(std::shared_ptr<const MappedFile> pack, const PackIndex::Entry& entry)
+    :
+    metaInfo(),
+    data(),
+    mapping(std::move(pack)),
+    mappedData()
+{
+    metaInfo.name = entry.name;
+    metaInfo.manifest = entry.manifest;
+    const auto stored = entry.blob.has_value() 
+        ? mapping->GetRange(0, entry.size) 
+        : mapping->GetRange(entry.offset, entry.storedSize);
+
+    if (entry.codec == Codec::Store or entry.blob.has_value())
+    {
+        mappedData = stored;
+        return;
+    }
+
+    // Compressed data cannot be viewed in place
+    data.resize(entry.size);
+    Decompressor::DecompressAll(entry.codec, stored, data);
+    mapping.reset();
+}
+
+void MCPacker::Mod::WriteToPack(PackWriter& modPackFile) const
+{
+    modPackFile.Append(GetData());
 }
 
 void MCPacker::Mod::WriteToFile(std::filesystem::path where) const
 {
-    auto end = std::ranges::find_if(metaInfo.name, Utility::EqualsZero<char32_t>());
-    auto pathToJar = where / std::u32string_view(std::begin(metaInfo.name), end);
+    const auto pathToJar = where / metaInfo.GetName();
 
+    const auto contents = GetData();
     OutputBinaryFile jar(pathToJar, std::ios::binary | std::ios::out | std::ios::trunc);
-    jar.write(data.data(), data.size());
+    jar.write(contents.data(), contents.size());
+    jar.close();
+    if (not jar)
+    {
+        const auto message = format("Unable to write file %1%!") % std::quoted(pathToJar.string());
+        throw std::runtime_error(message.str());
+    }
+}
+
+const MCPacker::Mod::MetaInfo& MCPacker::Mod::GetMetaInfo() const
+{
+    return metaInfo;
+}
+
+std::span<const Byte> MCPacker::Mod::GetData() const
+{
+    if (mapping != nullptr)
+    {
+        return mappedData;
+    }
+    return data;
+}
+
+std::optional<MCPacker::ModManifest> MCPacker::Mod::GetManifest() const
+{
+    if (metaInfo.manifest.has_value())
+    {
+        return metaInfo.manifest;
+    }
+    return ModManifest::Read(GetData());
 }
\ No newline at end of file
@@ -24,12 +24,20 @@
 #include <filesystem>
 #include <string>
 #include <array>
+#include <memory>
+#include <span>
 #include <Utility.hpp>
+#include "PackIndex.hpp"
+#include "MappedFile.hpp"
+#include "ModManifest.hpp"
+#include "FileReader.hpp"
 
 namespace MCPacker
 {
     constexpr size_t MaxModNameSize = 255;
 
+    class PackWriter;
+
     /// @brief Class that represents a mod
     /// @details This class stores a mod as a binary array and the mod's name
     class Mod 
@@ -41,10 +49,16 @@ namespace MCPacker
             static constexpr size_t NameLength = 255;
             static constexpr size_t NameLengthInBytes = NameLength * sizeof(char32_t);
 
-            /// @brief Mod's name in UTF-32 encoding
-            std::array<char32_t, NameLength> name;   
+            /// @brief Mod's name in UTF-8 encoding
+            std::string name;
+
+            /// @brief Manifest of the mod as stored in the pack's index, if the index carries one
+            std::optional<ModManifest> manifest;
 
             MetaInfo(); 
+
+            /// @brief Mod's name in UTF-32 encoding, it is converted on every call
+            std::u32string GetName() const;
         };
 
     private:
@@ -52,23 +66,66 @@ namespace MCPacker
 
         /// @brief Binary content of the mod 
         std::vector<Utility::Definitions::Byte> data;
+
+        /// @brief Mapping of the pack the mod was read from in `ReadingMode::Mapped`
+        std::shared_ptr<const MappedFile> mapping;
+
+        /// @brief Binary content of the mod inside `mapping`
+        std::span<const Utility::Definitions::Byte> mappedData;
     public:
         /// @brief Construct a mod from the corresponding `.jar` file
         /// @param pathToJar
-        Mod(std::filesystem::path pathToJar);
+        /// @throws std::invalid_argument if the jar does not exist or its name is too long
+        /// @throws std::runtime_error if the jar cannot be read
+        Mod(std::filesystem::path pathToJar, const ReadOptions& options = ReadOptions());
+
+        /// @brief Construct a mod from a `.jar` file opened earlier, e.g. to learn its size first
+        Mod(FileReader&& jar);
 
+        /// @brief Construct a mod from the content of a `.jar` file read elsewhere
+        /// @throws std::invalid_argument if the jar's name is too long
+        Mod(const std::filesystem::path& pathToJar, std::vector<Utility::Definitions::Byte> data);
 
-        /// @brief Construct from a `pack` file
-        /// @param pack 
+
+        /// @brief Construct from a legacy `pack` file, whose mods are stored one after another
+        /// @param pack Stream positioned at the beginning of the mod's record
         Mod(Utility::Definitions::InputBinaryFile& pack, Utility::ReadingMode readingMode = Utility::ReadingMode::Full);
 
-        /// @brief Write this mod's representation into `ModPack` file
+        /// @brief Construct from an indexed `pack` file
+        /// @param pack Stream of the pack, it is only touched in `ReadingMode::Full`
+        /// @param entry Entry of the pack's index describing the mod
+        /// @param blobStore Store to read the mod from if the pack only references it
+        /// @throws std::runtime_error if the mod lies outside of the pack or its data is damaged
+        Mod(Utility::Definitions::InputBinaryFile& pack, const PackIndex::Entry& entry, Utility::ReadingMode readingMode = Utility::ReadingMode::Full, 
+            const BlobStore* blobStore = nullptr);
+
+        /// @brief Construct a view of the mod inside a mapped `pack` file
+        /// @param pack Mapping of the pack, or of the mod's blob if the pack only references it.
+        /// The mod shares its ownership
+        /// @param entry Entry of the pack's index describing the mod
+        /// @details The data is neither copied nor checked against the entry's checksum,
+        /// unless it is compressed, in which case it is decompressed into memory
+        Mod(std::shared_ptr<const MappedFile> pack, const PackIndex::Entry& entry);
+
+        /// @brief Write this mod's data into `ModPack` file
         /// @param modPackFile 
         /// @warning This function is only used by ModPack class
         /// Normally it shouldn't be called from anywhere else
-        void WriteToPack(Utility::Definitions::OutputBinaryFile& modPackFile) const;
+        void WriteToPack(PackWriter& modPackFile) const;
 
+        /// @brief Write the mod into `where` under its own name
+        /// @throws std::runtime_error if the file cannot be written
         void WriteToFile(std::filesystem::path where) const;
+
+        const MetaInfo& GetMetaInfo() const;
+
+        /// @brief Binary content of the mod, either owned or viewed inside a mapped pack
+        std::span<const Utility::Definitions::Byte> GetData() const;
+
+        /// @brief Metadata the mod declares in its jar
+        /// @details It is taken from the pack's index when the index carries it, otherwise it is read
+        /// from the mod's data, which is only available unless the mod is read with `ReadingMode::OnlyMetaInfo`
+        std::optional<ModManifest> GetManifest() const;
     };
 }
 
@@ -0,0 +1,824 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/endian/conversion.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <zlib.h>
+#include "ModManifest.hpp"
+
+namespace pt = boost::property_tree;
+
+namespace
+{
+    // zlib declares its own `Byte` in the global namespace
+    using Byte = MCPacker::Utility::Definitions::Byte;
+    using MCPacker::ModManifest;
+    using Loader = ModManifest::Loader;
+    using Kind = ModManifest::Dependency::Kind;
+
+    /// @brief Fill `buffer` with the jar's bytes starting at `offset`, the range is always inside the jar
+    using Reader = std::function<void(uint64_t offset, std::span<Byte> buffer)>;
+
+    constexpr uint32_t EndOfCentralDirectorySignature = 0x06054b50;
+    constexpr uint32_t Zip64LocatorSignature = 0x07064b50;
+    constexpr uint32_t Zip64EndOfCentralDirectorySignature = 0x06064b50;
+    constexpr uint32_t CentralDirectoryEntrySignature = 0x02014b50;
+    constexpr uint32_t LocalHeaderSignature = 0x04034b50;
+
+    constexpr size_t EndOfCentralDirectorySize = 22;
+    constexpr size_t Zip64LocatorSize = 20;
+    constexpr size_t Zip64EndOfCentralDirectorySize = 56;
+    constexpr size_t CentralDirectoryEntrySize = 46;
+    constexpr size_t LocalHeaderSize = 30;
+    constexpr size_t MaxCommentSize = 0xffff;
+    constexpr uint16_t Zip64ExtraField = 0x0001;
+
+    constexpr uint16_t Stored = 0;
+    constexpr uint16_t Deflated = 8;
+
+    /// @brief Files with metadata in the order they are looked for, with the loader each of them belongs to
+    constexpr std::array<std::pair<std::string_view, Loader>, 4> ManifestFiles = {{
+        {"fabric.mod.json", Loader::Fabric},
+        {"META-INF/neoforge.mods.toml", Loader::NeoForge},
+        {"META-INF/mods.toml", Loader::Forge},
+        {"mcmod.info", Loader::LegacyForge}
+    }};
+
+    /// @brief Manifest of the jar itself, Forge mods may take their version from it
+    constexpr std::string_view JarManifestFile = "META-INF/MANIFEST.MF";
+    constexpr std::string_view JarVersionPlaceholder = "${file.jarVersion}";
+
+    /// @brief Numbers in ZIP structures are little-endian
+    template<typename T>
+    T Load(std::span<const Byte> data, size_t offset)
+    {
+        if (offset > data.size() or data.size() - offset < sizeof(T))
+        {
+            throw std::runtime_error("ZIP structure is truncated!");
+        }
+        return boost::endian::endian_load<T, sizeof(T), boost::endian::order::little>(
+            reinterpret_cast<const unsigned char*>(data.data() + offset));
+    }
+
+    std::vector<Byte> ReadRange(const Reader& read, uint64_t offset, uint64_t size)
+    {
+        std::vector<Byte> range(size);
+        read(offset, range);
+        return range;
+    }
+
+    /// @brief Location of a file inside the jar as recorded in the central directory
+    struct ZipEntry
+    {
+        uint16_t method;
+        uint64_t compressedSize;
+        uint64_t size;
+        uint64_t localHeaderOffset;
+    };
+
+    /// @brief Replace the fields of `entry` that do not fit into 32 bits with their values from ZIP64 extra field
+    void ReadZip64Extra(std::span<const Byte> extra, ZipEntry& entry)
+    {
+        constexpr uint32_t Overflow = 0xffffffff;
+        for (size_t position = 0; position + 4 <= extra.size(); )
+        {
+            const auto id = Load<uint16_t>(extra, position);
+            const auto size = Load<uint16_t>(extra, position + 2);
+            const auto field = extra.subspan(position + 4, std::min<size_t>(size, extra.size() - position - 4));
+            position += 4 + size;
+            if (id != Zip64ExtraField)
+            {
+                continue;
+            }
+
+            // Only the overflown fields are present, in this order
+            size_t offset = 0;
+            for (auto* value : {&entry.size, &entry.compressedSize, &entry.localHeaderOffset})
+            {
+                if (*value == Overflow)
+                {
+                    *value = Load<uint64_t>(field, offset);
+                    offset += sizeof(uint64_t);
+                }
+            }
+            return;
+        }
+    }
+
+    /// @brief Look `names` up in the central directory of the jar
+    /// @return Entries of the files found, an empty map if the jar is not a ZIP archive
+    std::unordered_map<std::string, ZipEntry> FindEntries(const Reader& read, uint64_t jarSize,
+        std::span<const std::string_view> names)
+    {
+        if (jarSize < EndOfCentralDirectorySize)
+        {
+            return {};
+        }
+
+        const auto tailSize = std::min<uint64_t>(jarSize, Zip64LocatorSize + EndOfCentralDirectorySize + MaxCommentSize);
+        const auto tail = ReadRange(read, jarSize - tailSize, tailSize);
+
+        // The record is followed by a comment of unknown size, so it is searched for from the end
+        std::optional<size_t> end;
+        for (size_t i = tail.size() - EndOfCentralDirectorySize + 1; i-- > 0; )
+        {
+            if (Load<uint32_t>(tail, i) == EndOfCentralDirectorySignature
+                and i + EndOfCentralDirectorySize + Load<uint16_t>(tail, i + 20) <= tail.size())
+            {
+                end = i;
+                break;
+            }
+        }
+        if (not end.has_value())
+        {
+            return {};
+        }
+
+        uint64_t entryCount = Load<uint16_t>(tail, *end + 10);
+        uint64_t directorySize = Load<uint32_t>(tail, *end + 12);
+        uint64_t directoryOffset = Load<uint32_t>(tail, *end + 16);
+        if (entryCount == 0xffff or directorySize == 0xffffffff or directoryOffset == 0xffffffff)
+        {
+            if (*end < Zip64LocatorSize or Load<uint32_t>(tail, *end - Zip64LocatorSize) != Zip64LocatorSignature)
+            {
+                throw std::runtime_error("ZIP64 end of central directory locator is missing!");
+            }
+            const auto recordOffset = Load<uint64_t>(tail, *end - Zip64LocatorSize + 8);
+            if (recordOffset > jarSize - std::min<uint64_t>(jarSize, Zip64EndOfCentralDirectorySize))
+            {
+                throw std::runtime_error("ZIP64 end of central directory lies outside of the jar!");
+            }
+            const auto record = ReadRange(read, recordOffset, Zip64EndOfCentralDirectorySize);
+            if (Load<uint32_t>(record, 0) != Zip64EndOfCentralDirectorySignature)
+            {
+                throw std::runtime_error("ZIP64 end of central directory is corrupted!");
+            }
+            entryCount = Load<uint64_t>(record, 32);
+            directorySize = Load<uint64_t>(record, 40);
+            directoryOffset = Load<uint64_t>(record, 48);
+        }
+        if (directoryOffset > jarSize or directorySize > jarSize - directoryOffset)
+        {
+            throw std::runtime_error("Central directory lies outside of the jar!");
+        }
+
+        const auto directory = ReadRange(read, directoryOffset, directorySize);
+        std::unordered_map<std::string, ZipEntry> found;
+        size_t position = 0;
+        for (uint64_t i = 0; i < entryCount and found.size() < names.size(); ++i)
+        {
+            if (Load<uint32_t>(directory, position) != CentralDirectoryEntrySignature)
+            {
+                throw std::runtime_error("Central directory is corrupted!");
+            }
+            ZipEntry entry{
+                .method = Load<uint16_t>(directory, position + 10),
+                .compressedSize = Load<uint32_t>(directory, position + 20),
+                .size = Load<uint32_t>(directory, position + 24),
+                .localHeaderOffset = Load<uint32_t>(directory, position + 42)
+            };
+            const size_t nameLength = Load<uint16_t>(directory, position + 28);
+            const size_t extraLength = Load<uint16_t>(directory, position + 30);
+            const size_t commentLength = Load<uint16_t>(directory, position + 32);
+            const auto nameOffset = position + CentralDirectoryEntrySize;
+            if (nameOffset + nameLength + extraLength > directory.size())
+            {
+                throw std::runtime_error("Central directory is truncated!");
+            }
+
+            const std::string_view name(directory.data() + nameOffset, nameLength);
+            if (std::ranges::find(names, name) != std::end(names))
+            {
+                ReadZip64Extra(std::span(directory).subspan(nameOffset + nameLength, extraLength), entry);
+                found.emplace(name, entry);
+            }
+            position = nameOffset + nameLength + extraLength + commentLength;
+        }
+        return found;
+    }
+
+    /// @brief Read and, if needed, inflate a file of the jar
+    std::string Extract(const Reader& read, uint64_t jarSize, const ZipEntry& entry)
+    {
+        if (entry.size > ModManifest::MaxSize or entry.compressedSize > ModManifest::MaxSize)
+        {
+            throw std::runtime_error("File is too big to be a manifest!");
+        }
+        if (entry.localHeaderOffset > jarSize or jarSize - entry.localHeaderOffset < LocalHeaderSize)
+        {
+            throw std::runtime_error("Local file header lies outside of the jar!");
+        }
+
+        const auto header = ReadRange(read, entry.localHeaderOffset, LocalHeaderSize);
+        if (Load<uint32_t>(header, 0) != LocalHeaderSignature)
+        {
+            throw std::runtime_error("Local file header is corrupted!");
+        }
+        const auto dataOffset = entry.localHeaderOffset + LocalHeaderSize + Load<uint16_t>(header, 26) + Load<uint16_t>(header, 28);
+        if (dataOffset > jarSize or entry.compressedSize > jarSize - dataOffset)
+        {
+            throw std::runtime_error("File lies outside of the jar!");
+        }
+        const auto compressed = ReadRange(read, dataOffset, entry.compressedSize);
+
+        if (entry.method == Stored)
+        {
+            return std::string(std::begin(compressed), std::end(compressed));
+        }
+        if (entry.method != Deflated)
+        {
+            throw std::runtime_error("Unsupported compression method!");
+        }
+
+        std::string inflated(entry.size, '\0');
+        z_stream stream{};
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        {
+            throw std::runtime_error("Unable to initialise zlib!");
+        }
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<Byte*>(compressed.data()));
+        stream.avail_in = static_cast<uInt>(compressed.size());
+        stream.next_out = reinterpret_cast<Bytef*>(inflated.data());
+        stream.avail_out = static_cast<uInt>(inflated.size());
+        const auto result = inflate(&stream, Z_FINISH);
+        const auto produced = stream.total_out;
+        inflateEnd(&stream);
+
+        if (result != Z_STREAM_END or produced != inflated.size())
+        {
+            throw std::runtime_error("File is corrupted!");
+        }
+        return inflated;
+    }
+
+    /// @brief Parser of as much of TOML as `mods.toml` files use
+    /// @details Values are kept as they are written, except strings which are unquoted and unescaped.
+    /// Arrays and inline tables are skipped, since nothing MCPacker reads is stored in them
+    class TOMLReader
+    {
+    public:
+        struct Table
+        {
+            std::string name;
+            std::unordered_map<std::string, std::string> values;
+
+            std::string Get(const std::string& key) const
+            {
+                const auto value = values.find(key);
+                return value != std::end(values) ? value->second : std::string();
+            }
+        };
+
+    private:
+        std::string_view document;
+        size_t position;
+
+        char Peek() const
+        {
+            return position < document.size() ? document[position] : '\0';
+        }
+
+        void SkipSpaces()
+        {
+            while (Peek() == ' ' or Peek() == '\t')
+            {
+                ++position;
+            }
+        }
+
+        void SkipLine()
+        {
+            const auto end = document.find('\n', position);
+            position = end == std::string_view::npos ? document.size() : end + 1;
+        }
+
+        std::string ReadBasicString()
+        {
+            std::string value;
+            ++position;
+            while (true)
+            {
+                if (position >= document.size() or document[position] == '\n')
+                {
+                    throw std::runtime_error("Unterminated string in TOML!");
+                }
+                const char character = document[position++];
+                if (character == '"')
+                {
+                    return value;
+                }
+                if (character != '\\')
+                {
+                    value += character;
+                    continue;
+                }
+
+                const char escaped = Peek();
+                ++position;
+                switch (escaped)
+                {
+                    case 'n': value += '\n'; break;
+                    case 't': value += '\t'; break;
+                    case 'r': value += '\r'; break;
+                    case 'b': value += '\b'; break;
+                    case 'f': value += '\f'; break;
+                    case '"': value += '"'; break;
+                    case '\\': value += '\\'; break;
+                    case 'u':
+                    case 'U':
+                    {
+                        const size_t digits = escaped == 'u' ? 4 : 8;
+                        uint32_t codePoint = 0;
+                        const auto hex = document.substr(position, digits);
+                        const auto [end, error] = std::from_chars(hex.data(), hex.data() + hex.size(), codePoint, 16);
+                        if (error != std::errc() or end != hex.data() + digits)
+                        {
+                            throw std::runtime_error("Malformed escape sequence in TOML!");
+                        }
+                        utf8::append(codePoint, std::back_inserter(value));
+                        position += digits;
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error("Malformed escape sequence in TOML!");
+                }
+            }
+        }
+
+        void SkipNested()
+        {
+            int depth = 0;
+            while (position < document.size())
+            {
+                const char character = Peek();
+                if (character == '"' or character == '\'')
+                {
+                    ReadValue();
+                    continue;
+                }
+                if (character == '#')
+                {
+                    SkipLine();
+                    continue;
+                }
+
+                ++position;
+                if (character == '[' or character == '{')
+                {
+                    ++depth;
+                }
+                else if ((character == ']' or character == '}') and --depth == 0)
+                {
+                    return;
+                }
+            }
+            throw std::runtime_error("Unterminated array in TOML!");
+        }
+
+        std::string ReadValue()
+        {
+            if (document.substr(position, 3) == R"(""")" or document.substr(position, 3) == "'''")
+            {
+                const auto delimiter = document.substr(position, 3);
+                position += 3;
+                // A newline right after the opening delimiter is not a part of the string
+                position += document.substr(position, 2) == "\r\n" ? 2 : Peek() == '\n' ? 1 : 0;
+                const auto end = document.find(delimiter, position);
+                if (end == std::string_view::npos)
+                {
+                    throw std::runtime_error("Unterminated string in TOML!");
+                }
+                std::string value(document.substr(position, end - position));
+                position = end + delimiter.size();
+                return value;
+            }
+
+            switch (Peek())
+            {
+                case '"':
+                    return ReadBasicString();
+
+                case '\'':
+                {
+                    const auto end = document.find_first_of("'\n", position + 1);
+                    if (end == std::string_view::npos or document[end] != '\'')
+                    {
+                        throw std::runtime_error("Unterminated string in TOML!");
+                    }
+                    std::string value(document.substr(position + 1, end - position - 1));
+                    position = end + 1;
+                    return value;
+                }
+
+                case '[':
+                case '{':
+                    SkipNested();
+                    return std::string();
+
+                default:
+                {
+                    const auto end = std::min(document.find_first_of("#\r\n", position), document.size());
+                    const auto value = document.substr(position, end - position);
+                    position = end;
+                    return boost::algorithm::trim_copy(std::string(value));
+                }
+            }
+        }
+
+        std::string ReadKey()
+        {
+            if (Peek() == '"' or Peek() == '\'')
+            {
+                return ReadValue();
+            }
+            const auto end = std::min(document.find_first_of(" \t=\r\n", position), document.size());
+            std::string key(document.substr(position, end - position));
+            position = end;
+            return key;
+        }
+
+    public:
+        TOMLReader(std::string_view document)
+            :
+            document(document),
+            position(0)
+        {
+
+        }
+
+        /// @brief Parse the document into its tables, the first one holds the top-level keys
+        std::vector<Table> Parse()
+        {
+            std::vector<Table> tables(1);
+            while (true)
+            {
+                while (position < document.size() and std::string_view(" \t\r\n").find(document[position]) != std::string_view::npos)
+                {
+                    ++position;
+                }
+                if (position == document.size())
+                {
+                    return tables;
+                }
+
+                if (Peek() == '#')
+                {
+                    SkipLine();
+                    continue;
+                }
+                if (Peek() == '[')
+                {
+                    const size_t brackets = document.substr(position, 2) == "[[" ? 2 : 1;
+                    const auto end = document.find(']', position);
+                    if (end == std::string_view::npos)
+                    {
+                        throw std::runtime_error("Unterminated table header in TOML!");
+                    }
+                    Table table;
+                    table.name = boost::algorithm::trim_copy(std::string(document.substr(position + brackets, end - position - brackets)));
+                    tables.push_back(std::move(table));
+                    position = end;
+                    SkipLine();
+                    continue;
+                }
+
+                auto key = ReadKey();
+                SkipSpaces();
+                if (Peek() != '=')
+                {
+                    throw std::runtime_error("Malformed key-value pair in TOML!");
+                }
+                ++position;
+                SkipSpaces();
+                tables.back().values.insert_or_assign(std::move(key), ReadValue());
+                SkipLine();
+            }
+        }
+    };
+
+    /// @brief Loaders write "any version" in different ways, it is always stored as an empty range
+    std::string NormaliseRange(std::string range)
+    {
+        return range == "*" ? std::string() : range;
+    }
+
+    pt::ptree ReadJSON(const std::string& document)
+    {
+        pt::ptree tree;
+        std::istringstream stream(document);
+        pt::read_json(stream, tree);
+        return tree;
+    }
+
+    ModManifest ParseFabric(const std::string& document)
+    {
+        const auto tree = ReadJSON(document);
+        ModManifest manifest;
+        manifest.loader = Loader::Fabric;
+        manifest.id = tree.get<std::string>("id");
+        manifest.version = tree.get<std::string>("version", "");
+
+        if (const auto provides = tree.get_child_optional("provides"))
+        {
+            for (const auto& [unused, id] : *provides)
+            {
+                manifest.provides.push_back(id.data());
+            }
+        }
+
+        constexpr std::array<std::pair<const char*, Kind>, 5> Sections = {{
+            {"depends", Kind::Required},
+            {"recommends", Kind::Optional},
+            {"suggests", Kind::Optional},
+            {"breaks", Kind::Conflict},
+            {"conflicts", Kind::Conflict}
+        }};
+        for (const auto& [section, kind] : Sections)
+        {
+            const auto dependencies = tree.get_child_optional(section);
+            if (not dependencies)
+            {
+                continue;
+            }
+            for (const auto& [id, ranges] : *dependencies)
+            {
+                // A list of ranges means that any of them is accepted
+                std::string range = ranges.data();
+                for (const auto& [unused, alternative] : ranges)
+                {
+                    range += (range.empty() ? "" : " || ") + alternative.data();
+                }
+                manifest.dependencies.emplace_back(id, NormaliseRange(std::move(range)), kind);
+            }
+        }
+        return manifest;
+    }
+
+    ModManifest ParseForge(const std::string& document, Loader loader)
+    {
+        ModManifest manifest;
+        manifest.loader = loader;
+        for (const auto& table : TOMLReader(document).Parse())
+        {
+            if (table.name == "mods")
+            {
+                // Every mod of the jar after the first one is bundled with it
+                auto id = table.Get("modId");
+                if (manifest.id.empty())
+                {
+                    manifest.id = std::move(id);
+                    manifest.version = table.Get("version");
+                }
+                else
+                {
+                    manifest.provides.push_back(std::move(id));
+                }
+            }
+            else if (table.name.starts_with("dependencies."))
+            {
+                // NeoForge and recent Forge say `type`, older Forge only `mandatory`
+                const auto type = table.Get("type");
+                auto kind = table.Get("mandatory") == "false" ? Kind::Optional : Kind::Required;
+                if (type == "optional")
+                {
+                    kind = Kind::Optional;
+                }
+                else if (type == "incompatible" or type == "discouraged")
+                {
+                    kind = Kind::Conflict;
+                }
+                manifest.dependencies.emplace_back(table.Get("modId"), NormaliseRange(table.Get("versionRange")), kind);
+            }
+        }
+
+        if (manifest.id.empty())
+        {
+            throw std::runtime_error("Jar declares no mods!");
+        }
+        return manifest;
+    }
+
+    ModManifest ParseLegacyForge(const std::string& document)
+    {
+        const auto tree = ReadJSON(document);
+        // Either a list of mods or, since the second version of the format, an object holding one
+        const auto& mods = tree.get_child_optional("modList") ? tree.get_child("modList") : tree;
+
+        ModManifest manifest;
+        manifest.loader = Loader::LegacyForge;
+        for (const auto& [unused, mod] : mods)
+        {
+            auto id = mod.get<std::string>("modid");
+            if (manifest.id.empty())
+            {
+                manifest.id = std::move(id);
+                manifest.version = mod.get<std::string>("version", "");
+            }
+            else
+            {
+                manifest.provides.push_back(std::move(id));
+            }
+
+            // Entries are `modid` or `modid@range`
+            if (const auto requiredMods = mod.get_child_optional("requiredMods"))
+            {
+                for (const auto& [unused, dependency] : *requiredMods)
+                {
+                    const auto& value = dependency.data();
+                    const auto separator = value.find('@');
+                    manifest.dependencies.emplace_back(value.substr(0, separator),
+                        separator == std::string::npos ? std::string() : NormaliseRange(value.substr(separator + 1)), Kind::Required);
+                }
+            }
+        }
+
+        if (manifest.id.empty())
+        {
+            throw std::runtime_error("Jar declares no mods!");
+        }
+        return manifest;
+    }
+
+    /// @brief Value of `Implementation-Version` in the jar's `MANIFEST.MF`
+    std::string ReadImplementationVersion(std::string_view jarManifest)
+    {
+        constexpr std::string_view Attribute = "Implementation-Version:";
+        std::string version;
+        bool found = false;
+        std::istringstream lines{std::string(jarManifest)};
+        for (std::string line; std::getline(lines, line); )
+        {
+            if (not line.empty() and line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            // Long values continue on the following lines, which start with a space
+            if (found and line.starts_with(' '))
+            {
+                version += line.substr(1);
+            }
+            else if (found)
+            {
+                break;
+            }
+            else if (line.starts_with(Attribute))
+            {
+                version = boost::algorithm::trim_copy(line.substr(Attribute.size()));
+                found = true;
+            }
+        }
+        return version;
+    }
+
+    std::optional<ModManifest> ReadManifest(const Reader& read, uint64_t jarSize)
+    {
+        std::array<std::string_view, ManifestFiles.size() + 1> names;
+        std::ranges::transform(ManifestFiles, std::begin(names), [](const auto& file) { return file.first; });
+        names.back() = JarManifestFile;
+
+        std::unordered_map<std::string, ZipEntry> entries;
+        try
+        {
+            entries = FindEntries(read, jarSize, names);
+        }
+        catch (const std::exception&)
+        {
+            // Metadata is only a convenience, a jar it cannot be read from is stored all the same
+            return std::nullopt;
+        }
+
+        for (const auto& [name, loader] : ManifestFiles)
+        {
+            const auto entry = entries.find(std::string(name));
+            if (entry == std::end(entries))
+            {
+                continue;
+            }
+
+            try
+            {
+                const auto document = Extract(read, jarSize, entry->second);
+                auto manifest = loader == Loader::Fabric ? ParseFabric(document)
+                    : loader == Loader::LegacyForge ? ParseLegacyForge(document)
+                    : ParseForge(document, loader);
+
+                if (manifest.version == JarVersionPlaceholder)
+                {
+                    const auto jarManifest = entries.find(std::string(JarManifestFile));
+                    manifest.version = jarManifest != std::end(entries)
+                        ? ReadImplementationVersion(Extract(read, jarSize, jarManifest->second))
+                        : std::string();
+                }
+                return manifest;
+            }
+            catch (const std::exception&)
+            {
+                // Multiloader jars may still have metadata of another loader
+            }
+        }
+        return std::nullopt;
+    }
+}
+
+MCPacker::ModManifest::Dependency::Dependency()
+    :
+    id(),
+    versionRange(),
+    kind(Kind::Required)
+{
+
+}
+
+MCPacker::ModManifest::Dependency::Dependency(std::string id, std::string versionRange, Kind kind)
+    :
+    id(std::move(id)),
+    versionRange(std::move(versionRange)),
+    kind(kind)
+{
+
+}
+
+MCPacker::ModManifest::ModManifest()
+    :
+    loader(Loader::Fabric),
+    id(),
+    version(),
+    provides(),
+    dependencies()
+{
+
+}
+
+std::string_view MCPacker::ModManifest::GetLoaderName(Loader loader)
+{
+    switch (loader)
+    {
+        case Loader::Fabric:
+            return "Fabric";
+        case Loader::Forge:
+            return "Forge";
+        case Loader::NeoForge:
+            return "NeoForge";
+        case Loader::LegacyForge:
+            return "legacy Forge";
+    }
+    return "unknown loader";
+}
+
+std::optional<MCPacker::ModManifest> MCPacker::ModManifest::Read(std::span<const Utility::Definitions::Byte> jar)
+{
+    return ReadManifest(
+        [jar](uint64_t offset, std::span<Utility::Definitions::Byte> buffer)
+        {
+            std::ranges::copy(jar.subspan(offset, buffer.size()), std::begin(buffer));
+        }, jar.size());
+}
+
+std::optional<MCPacker::ModManifest> MCPacker::ModManifest::Read(Utility::Definitions::InputBinaryFile& jar)
+{
+    jar.seekg(0, std::ios::end);
+    const auto size = jar.tellg();
+    std::optional<ModManifest> manifest;
+    if (jar and size >= 0)
+    {
+        manifest = ReadManifest(
+            [&jar](uint64_t offset, std::span<Utility::Definitions::Byte> buffer)
+            {
+                jar.seekg(static_cast<std::streamoff>(offset));
+                jar.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                if (not jar)
+                {
+                    throw std::runtime_error("Unexpected end of the jar!");
+                }
+            }, static_cast<uint64_t>(size));
+    }
+
+    jar.clear();
+    jar.seekg(0);
+    return manifest;
+}
\ No newline at end of file
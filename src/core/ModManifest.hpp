@@ -0,0 +1,97 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOD_MANIFEST_HPP
+#define MOD_MANIFEST_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Utility.hpp>
+
+namespace MCPacker
+{
+    /// @brief Metadata a mod declares about itself inside its jar
+    /// @details It is taken from `fabric.mod.json` of Fabric mods, `META-INF/neoforge.mods.toml` of NeoForge ones,
+    /// `META-INF/mods.toml` of Forge ones and `mcmod.info` of legacy Forge ones.
+    /// Only the end of the jar with the ZIP central directory and the file with the metadata are read,
+    /// the rest of the jar is never touched
+    struct ModManifest
+    {
+        enum class Loader : uint8_t
+        {
+            Fabric,
+            Forge,
+            NeoForge,
+            LegacyForge
+        };
+
+        struct Dependency
+        {
+            enum class Kind : uint8_t
+            {
+                Required,
+                Optional,
+                /// @brief The mod does not work together with the dependency
+                Conflict
+            };
+
+            std::string id;
+
+            /// @brief Accepted versions in the syntax of the mod's loader, empty if any version is accepted
+            std::string versionRange;
+            Kind kind;
+
+            Dependency();
+            Dependency(std::string id, std::string versionRange, Kind kind);
+
+            bool operator==(const Dependency&) const = default;
+        };
+
+        /// @brief Largest file with metadata that is read, anything bigger is not a real manifest
+        static constexpr uint64_t MaxSize = 1 << 20;
+
+        Loader loader;
+        std::string id;
+        std::string version;
+
+        /// @brief Other IDs the jar satisfies dependencies on, e.g. of mods bundled with the main one
+        std::vector<std::string> provides;
+        std::vector<Dependency> dependencies;
+
+        ModManifest();
+
+        bool operator==(const ModManifest&) const = default;
+
+        /// @brief Name of the loader to show to users
+        static std::string_view GetLoaderName(Loader loader);
+
+        /// @brief Read the manifest of a jar in memory, e.g. mapped from a pack
+        /// @return `std::nullopt` if the jar is not a ZIP archive or has no metadata that can be understood
+        static std::optional<ModManifest> Read(std::span<const Utility::Definitions::Byte> jar);
+
+        /// @brief Read the manifest of a jar file
+        /// @details The stream is left positioned at the beginning of the jar
+        static std::optional<ModManifest> Read(Utility::Definitions::InputBinaryFile& jar);
+    };
+}
+
+#endif //MOD_MANIFEST_HPP
\ No newline at end of file
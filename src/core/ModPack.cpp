@@ -18,14 +18,117 @@
 #include <fstream>
 #include <algorithm>
 #include <ranges>
+#include <iomanip>
+#include <stdexcept>
+#include <atomic>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <functional>
 #include <boost/format.hpp>
-#include <boost/algorithm/cxx11/copy_if.hpp>
+#include <boost/numeric/conversion/cast.hpp>
 #include "ModPack.hpp"
+#include "DeployManifest.hpp"
+#include "IoRing.hpp"
+#include "MappedFile.hpp"
+#include "OrderedHandOff.hpp"
+#include "ParallelFor.hpp"
+#include "PackExtractor.hpp"
+#include "PackWriter.hpp"
 #include "Utility.hpp"
 
 using boost::format;
 using namespace MCPacker::Utility::Definitions;
 using MCPacker::Utility::ReadingMode;
+namespace fs = std::filesystem;
+
+namespace
+{
+    using MCPacker::PackIndex;
+
+    /// @brief Check whether `file` already holds a mod of `size` bytes with the checksum `getChecksum` returns
+    /// @param getChecksum Computes the mod's checksum, it is only called once the file's size matches
+    /// @param algorithm Algorithm the checksum is computed with
+    /// @param record Record of the file in the directory's manifest, its checksum is trusted
+    /// if the file has not been modified since it was made
+    bool IsUpToDate(const fs::path& file, uint64_t size, const std::function<uint64_t()>& getChecksum, PackIndex::ChecksumAlgorithm algorithm, 
+        const std::optional<MCPacker::DeployManifest::Record>& record)
+    {
+        if (record.has_value() and record->size == size and record->checksum.has_value() and MCPacker::DeployManifest::Matches(file, *record))
+        {
+            return record->checksumAlgorithm == algorithm and *record->checksum == getChecksum();
+        }
+
+        std::error_code error;
+        if (not fs::is_regular_file(file, error) or fs::file_size(file, error) != size or error)
+        {
+            return false;
+        }
+
+        InputBinaryFile existing(file, std::ios::binary);
+        try
+        {
+            return PackIndex::Checksum(existing, size, algorithm) == getChecksum();
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+    }
+
+    /// @brief Read jars on `options.workers` threads and put the mods into `added` in the order of `pathsToJars`
+    void ReadJars(const std::vector<fs::path>& pathsToJars, const MCPacker::ModPack::IngestOptions& options, std::vector<MCPacker::Mod>& added)
+    {
+        MCPacker::OrderedHandOff<MCPacker::Mod> handOff(pathsToJars.size(), options.maxBytesInFlight);
+        bool failed = false;
+        std::mutex mutex;
+        std::condition_variable budgetReleased;
+
+        MCPacker::ParallelFor(pathsToJars.size(), options.workers, 
+            [&](size_t i)
+            {
+                try
+                {
+                    MCPacker::FileReader jar(pathsToJars[i], options.read);
+                    {
+                        std::unique_lock lock(mutex);
+                        budgetReleased.wait(lock, 
+                            [&]()
+                            {
+                                return failed or handOff.CanAdmit(i, jar.GetSize());
+                            });
+                        if (failed)
+                        {
+                            return;
+                        }
+                        handOff.Admit(i, jar.GetSize());
+                    }
+
+                    MCPacker::Mod mod(std::move(jar));
+
+                    std::lock_guard lock(mutex);
+                    const auto handedOver = handOff.Finish(i, std::move(mod), 
+                        [&added](size_t, MCPacker::Mod&& finished)
+                        {
+                            added.push_back(std::move(finished));
+                        });
+                    if (handedOver != 0)
+                    {
+                        budgetReleased.notify_all();
+                    }
+                }
+                catch (...)
+                {
+                    {
+                        std::lock_guard lock(mutex);
+                        failed = true;
+                    }
+                    budgetReleased.notify_all();
+                    throw;
+                }
+            });
+    }
+}
 
 const std::u32string_view MCPacker::ModPack::MetaInfo::PackExt = U".pck";
 
@@ -34,27 +137,196 @@ MCPacker::ModPack::MetaInfo::MetaInfo()
     name(),
     description()
 {
-    name.fill(0);
-    description.fill(0);
+
+}
+
+MCPacker::ModPack::MetaInfo::MetaInfo(std::u32string_view name, std::optional<std::u32string_view> description)
+    :
+    MetaInfo()
+{
+    if (name.size() > NameLength or description.value_or(std::u32string_view()).size() > DescriptionLength)
+    {
+        throw std::invalid_argument("Name or description of the pack is too long!");
+    }
+
+    this->name = Utility::UTF32ToUTF8(name);
+    
+    if (description.has_value())
+    {
+        this->description = Utility::UTF32ToUTF8(*description);
+    }
+}
+
+std::filesystem::path MCPacker::ModPack::MetaInfo::GetFileName() const
+{
+    auto nameWithExt = GetName();
+    std::ranges::copy(PackExt, std::back_inserter(nameWithExt));
+    return nameWithExt;
+}
+
+const std::string& MCPacker::ModPack::MetaInfo::GetNameInUTF8() const
+{
+    return name;
 }
 
-std::string MCPacker::ModPack::MetaInfo::GetNameInUTF8() const
+std::u32string MCPacker::ModPack::MetaInfo::GetName() const
 {
-    return Utility::UTF32ArrayToUTF8String(name);
+    return Utility::UTF8ToUTF32(name);
+}
+
+std::u32string MCPacker::ModPack::MetaInfo::GetDescription() const
+{
+    return Utility::UTF8ToUTF32(description);
+}
+
+MCPacker::ModPack::DeployOptions::DeployOptions()
+    :
+    workers(1),
+    incremental(false),
+    ioRing(true)
+{
+
+}
+
+MCPacker::ModPack::IngestOptions::IngestOptions()
+    :
+    workers(8),
+    maxBytesInFlight(256 << 20),
+    read(),
+    ioRing(true)
+{
+
 }
 
 MCPacker::ModPack::ModPack()
     :
     metaInfo(),
-    mods()
+    mods(),
+    index(),
+    sourceFile()
 {
 
 }
 
-MCPacker::ModPack::ModPack(std::filesystem::path packFile, Utility::ReadingMode readingMode)
+MCPacker::ModPack::ModPack(std::filesystem::path packFile, Utility::ReadingMode readingMode, std::shared_ptr<const BlobStore> blobStore)
+    :
+    ModPack()
 {
-    InputBinaryFile pack(packFile);
-    const auto packSize = std::filesystem::file_size(packFile);
+    this->blobStore = std::move(blobStore);
+
+    InputBinaryFile pack(packFile, std::ios::binary);
+    if (not pack.is_open())
+    {
+        const auto message = format("Unable to read file %1%!") % std::quoted(packFile.string());
+        throw std::runtime_error(message.str());
+    }
+
+    // In mapped mode the stream is only used to read the index, the data is viewed through the mapping
+    const auto streamReadingMode = readingMode == ReadingMode::Mapped ? ReadingMode::OnlyMetaInfo : readingMode;
+    if (PackIndex::ReadMagic(pack))
+    {
+        ReadIndexed(pack, streamReadingMode);
+    }
+    else
+    {
+        ReadLegacy(pack, streamReadingMode);
+    }
+
+    if (readingMode == ReadingMode::Mapped)
+    {
+        const auto mapping = std::make_shared<const MappedFile>(packFile);
+        mods.clear();
+        std::ranges::for_each(index, 
+            [this, &mapping](const PackIndex::Entry& entry)
+            {
+                if (entry.blob.has_value())
+                {
+                    mods.emplace_back(std::make_shared<const MappedFile>(entry.GetBlobPath(this->blobStore.get())), entry);
+                }
+                else
+                {
+                    mods.emplace_back(mapping, entry);
+                }
+            });
+    }
+
+    sourceFile = std::move(packFile);
+}
+
+MCPacker::ModPack::ModPack(std::filesystem::path packFile, const MetaInfo& metaInfo, PackIndex index, std::shared_ptr<const BlobStore> blobStore)
+    :
+    ModPack()
+{
+    this->metaInfo = metaInfo;
+    this->index = std::move(index);
+    this->blobStore = std::move(blobStore);
+    sourceFile = std::move(packFile);
+
+    // Mods only carry their names in this mode, so the stream is never touched
+    InputBinaryFile unused;
+    mods.reserve(this->index.GetSize());
+    std::ranges::for_each(this->index, 
+        [this, &unused](const PackIndex::Entry& entry)
+        {
+            mods.emplace_back(unused, entry, ReadingMode::OnlyMetaInfo);
+        });
+}
+
+void MCPacker::ModPack::ReadIndexed(InputBinaryFile& pack, Utility::ReadingMode readingMode)
+{
+    std::array<Byte, sizeof(uint16_t)> versionSerialised;
+    pack.read(versionSerialised.data(), versionSerialised.size());
+    const auto version = Utility::FromByteArray<uint16_t>(versionSerialised);
+
+    std::array<Byte, sizeof(uint64_t)> headerChecksum;
+    headerChecksum.fill(0);
+    if (version >= PackIndex::HashedVersion)
+    {
+        pack.read(headerChecksum.data(), headerChecksum.size());
+    }
+
+    PackIndex::Hasher header;
+    if (version >= PackIndex::CompactVersion)
+    {
+        metaInfo.name = PackIndex::ReadString(pack, &header);
+        metaInfo.description = PackIndex::ReadString(pack, &header);
+    }
+    else
+    {
+        std::array<Byte, MetaInfo::NameLength * sizeof(char32_t)> name;
+        std::array<Byte, MetaInfo::DescriptionLength * sizeof(char32_t)> description;
+        name.fill(0);
+        description.fill(0);
+        pack.read(name.data(), name.size());
+        pack.read(description.data(), description.size());
+
+        metaInfo.name = Utility::UTF8ArrayToString(name);
+        metaInfo.description = Utility::UTF8ArrayToString(description);
+        header.Update(name);
+        header.Update(description);
+    }
+    index = PackIndex::Read(pack, version, &header);
+
+    // A damaged index would send readers to arbitrary places of the file, so nothing is trusted past this point
+    if (version >= PackIndex::HashedVersion and header.GetDigest() != Utility::FromByteArray<uint64_t>(headerChecksum))
+    {
+        throw std::runtime_error("Pack's header is corrupted!");
+    }
+    mods.reserve(index.GetSize());
+    std::ranges::for_each(index, 
+        [this, &pack, readingMode](const PackIndex::Entry& entry)
+        {
+            mods.emplace_back(pack, entry, readingMode, blobStore.get());
+        });
+}
+
+void MCPacker::ModPack::ReadLegacy(InputBinaryFile& pack, Utility::ReadingMode readingMode)
+{
+    const uint64_t recordHeaderSize = Mod::MetaInfo::NameLengthInBytes + sizeof(uint64_t);
+
+    pack.seekg(0, std::ios::end);
+    const uint64_t packSize = pack.tellg();
+    pack.seekg(0);
 
     {
         std::array<Byte, MetaInfo::NameLength * sizeof(char32_t)> name;
@@ -65,40 +337,63 @@ MCPacker::ModPack::ModPack(std::filesystem::path packFile, Utility::ReadingMode
         pack.read(name.data(), name.size());
         pack.read(description.data(), description.size());
 
-        metaInfo.name = Utility::FromUTF8Array(name);
-        metaInfo.description = Utility::FromUTF8Array(description);
+        metaInfo.name = Utility::UTF8ArrayToString(name);
+        metaInfo.description = Utility::UTF8ArrayToString(description);
     }
 
-    while(pack.tellg() < packSize)
+    index = PackIndex(PackIndex::LegacyVersion);
+    while(static_cast<uint64_t>(pack.tellg()) < packSize)
     {
-        mods.emplace_back(pack, readingMode);
+        PackIndex::Entry entry;
+        entry.offset = static_cast<uint64_t>(pack.tellg()) + recordHeaderSize;
+
+        const auto& mod = mods.emplace_back(pack, readingMode);
+
+        entry.name = mod.GetMetaInfo().name;
+        entry.size = static_cast<uint64_t>(pack.tellg()) - entry.offset;
+        entry.storedSize = entry.size;
+        index.Add(std::move(entry));
     }
 }
 
-MCPacker::ModPack::ModPack(std::u32string_view name, std::optional<std::u32string_view> description, const std::vector<std::filesystem::path>& modPaths)
+MCPacker::ModPack::ModPack(std::u32string_view name, std::optional<std::u32string_view> description, const std::vector<std::filesystem::path>& modPaths,
+    const IngestOptions& options)
     :
     ModPack()
 {
-    std::ranges::copy(name, std::begin(metaInfo.name));
-    
-    if (description.has_value())
-    {
-        std::ranges::copy(*description, std::begin(metaInfo.description));
-    }
+    metaInfo = MetaInfo(name, description);
+    AddMods(modPaths, options);
+}
 
-    std::ranges::for_each(modPaths, 
-        [this](const auto& path)
-        {
-            AddMod(path);
-        });
+void MCPacker::ModPack::AddMod(std::filesystem::path pathToJar, const ReadOptions& options)
+{
+    mods.emplace_back(std::move(pathToJar), options);
 }
 
-void MCPacker::ModPack::AddMod(std::filesystem::path pathToJar)
+void MCPacker::ModPack::AddMods(const std::vector<std::filesystem::path>& pathsToJars, const IngestOptions& options)
 {
-    mods.emplace_back(pathToJar);
+    std::vector<Mod> added;
+    added.reserve(pathsToJars.size());
+
+    if (options.ioRing and options.read.directThreshold == 0 and pathsToJars.size() > 1 and IoRing::IsSupported())
+    {
+        IoRing ring;
+        ring.ReadFiles(pathsToJars, options.maxBytesInFlight, 
+            [&](size_t i, std::vector<Byte> data)
+            {
+                added.emplace_back(pathsToJars[i], std::move(data));
+            });
+    }
+    else
+    {
+        ReadJars(pathsToJars, options, added);
+    }
+
+    mods.reserve(mods.size() + added.size());
+    std::ranges::move(added, std::back_inserter(mods));
 }
 
-void MCPacker::ModPack::WriteToFile(std::filesystem::path where) const
+void MCPacker::ModPack::WriteToFile(std::filesystem::path where, const CompressionOptions& compression, const BlobStore* blobStore) const
 {
     if (not std::filesystem::is_directory(where))
     {
@@ -106,38 +401,422 @@ void MCPacker::ModPack::WriteToFile(std::filesystem::path where) const
         throw std::invalid_argument(message.str());
     }
 
-    std::u32string nameWithExt;
-    boost::algorithm::copy_until(metaInfo.name, std::back_inserter(nameWithExt), Utility::NotEqualsZero<char32_t>());
-    std::ranges::copy(MetaInfo::PackExt, std::back_inserter(nameWithExt));
+    where /= metaInfo.GetFileName();
 
-    where /= nameWithExt;
+    std::vector<PackWriter::ModName> modNames;
+    modNames.reserve(mods.size());
+    std::ranges::transform(mods, std::back_inserter(modNames), 
+        [](const Mod& mod)
+        {
+            return mod.GetMetaInfo().name;
+        });
 
-    OutputBinaryFile pack(where, std::ios::binary);
+    std::vector<std::span<const Byte>> modsData;
+    modsData.reserve(mods.size());
+    std::ranges::transform(mods, std::back_inserter(modsData), 
+        [](const Mod& mod)
+        {
+            return mod.GetData();
+        });
 
-    std::ranges::copy(Utility::ToUTF8Array<MetaInfo::NameLength>(std::u32string_view(std::begin(metaInfo.name), std::end(metaInfo.name))), std::ostreambuf_iterator(pack));
-    std::ranges::copy(Utility::ToUTF8Array<MetaInfo::DescriptionLength>(std::u32string_view(std::begin(metaInfo.description), std::end(metaInfo.description))), std::ostreambuf_iterator(pack));
-    std::ranges::for_each(mods, 
-        [&pack](const Mod& mod)
+    // The index is sized before anything is written, so the manifests have to be known upfront
+    std::vector<std::optional<ModManifest>> manifests(mods.size());
+    ParallelFor(mods.size(), compression.workers, 
+        [&](size_t i)
         {
-            mod.WriteToPack(pack);
+            manifests[i] = mods[i].GetManifest();
         });
+
+    // The blobs are only referenced once the pack is in place, so garbage collection has to wait until then
+    std::optional<BlobStore::Lock> lock;
+    if (blobStore != nullptr)
+    {
+        lock.emplace(*blobStore, BlobStore::Lock::Mode::Shared);
+    }
+
+    PackWriter writer(where, metaInfo, std::move(modNames), compression, std::move(manifests));
+    if (blobStore != nullptr)
+    {
+        // Putting mods into the store is independent from writing the pack, so it is done by the workers first
+        std::vector<BlobStore::Digest> digests(modsData.size());
+        std::vector<uint64_t> checksums(modsData.size());
+        ParallelFor(modsData.size(), compression.workers, 
+            [&](size_t i)
+            {
+                digests[i] = blobStore->Put(modsData[i]);
+                checksums[i] = PackIndex::Checksum(modsData[i].data(), modsData[i].size());
+            });
+
+        for (size_t i = 0; i < modsData.size(); ++i)
+        {
+            writer.AppendReference(modsData[i].size(), checksums[i], digests[i]);
+        }
+    }
+    else
+    {
+        writer.Append(modsData);
+    }
+    writer.Finish();
 }
 
-void MCPacker::ModPack::Deploy(std::filesystem::path where) const
+MCPacker::ModPack::DeployReport MCPacker::ModPack::Deploy(std::filesystem::path where, const DeployOptions& options) const
 {
+    using Clock = std::chrono::steady_clock;
+
     if (not std::filesystem::exists(where))
     {
         std::filesystem::create_directory(where);
     }
 
-    std::ranges::for_each(mods, 
-        [&where](const MCPacker::Mod& mod)
+    const auto deployStart = Clock::now();
+
+    // Packs read from a file are extracted straight from it, mods built from jars are written from memory
+    std::optional<PackExtractor> extractor;
+    if (not sourceFile.empty())
+    {
+        extractor.emplace(sourceFile, blobStore.get());
+    }
+
+    const size_t modCount = extractor.has_value() ? index.GetSize() : mods.size();
+    const auto previousManifest = DeployManifest::Load(where);
+
+    // Mods kept uncompressed in the pack are copied from it by the ring, like mods in memory are written
+    const bool useRing = options.ioRing and modCount > 1 and IoRing::IsSupported();
+    const auto getRingWrite = [&](size_t i, const std::filesystem::path& file) -> std::optional<IoRing::FileWrite>
+    {
+        if (not extractor.has_value())
+        {
+            return IoRing::FileWrite{.path = file, .data = mods[i].GetData(), .source = std::nullopt};
+        }
+        const auto source = extractor->GetStoredRange(index.At(i));
+        if (not source.has_value())
+        {
+            return std::nullopt;
+        }
+        return IoRing::FileWrite{.path = file, .data = {}, .source = source};
+    };
+    const auto getSize = [&](size_t i) -> uint64_t
+    {
+        return extractor.has_value() ? index.At(i).size : mods[i].GetData().size();
+    };
+
+    // Every worker only touches its own mod's slots
+    std::vector<std::filesystem::path> files(modCount);
+    std::vector<std::optional<DeployReport::FileTiming>> timings(modCount);
+    std::vector<std::optional<DeployManifest::Record>> records(modCount);
+    std::vector<std::atomic<bool>> started(modCount);
+    std::vector<std::optional<IoRing::FileWrite>> ringWrites(modCount);
+    std::vector<std::optional<uint64_t>> checksums(modCount);
+    std::vector<PackIndex::ChecksumAlgorithm> algorithms(modCount);
+
+    try
+    {
+        ParallelFor(modCount, options.workers, 
+            [&](size_t i)
+            {
+                const auto start = Clock::now();
+                const auto name = extractor.has_value() ? index.At(i).GetName() : mods[i].GetMetaInfo().GetName();
+                const auto size = getSize(i);
+                const auto algorithm = extractor.has_value() ? index.At(i).checksumAlgorithm : PackIndex::ChecksumAlgorithm::XXH3;
+                files[i] = where / name;
+
+                // Mods of legacy packs and of packs built from jars have to be hashed for their checksums,
+                // which is only done once an incremental deploy needs them. Records without one make the next
+                // incremental deploy hash the file instead
+                std::optional<uint64_t> checksum = extractor.has_value() ? index.At(i).checksum : std::nullopt;
+                const auto getChecksum = [&]()
+                {
+                    if (not checksum.has_value())
+                    {
+                        checksum = GetModChecksum(i);
+                    }
+                    return *checksum;
+                };
+
+                if (options.incremental and IsUpToDate(files[i], size, getChecksum, algorithm, previousManifest.Find(name)))
+                {
+                    records[i] = DeployManifest::MakeRecord(files[i], checksum, algorithm);
+                    return;
+                }
+
+                started[i] = true;
+                if (useRing)
+                {
+                    ringWrites[i] = getRingWrite(i, files[i]);
+                    if (ringWrites[i].has_value())
+                    {
+                        // Written below
+                        checksums[i] = checksum;
+                        algorithms[i] = algorithm;
+                        return;
+                    }
+                }
+
+                if (extractor.has_value())
+                {
+                    extractor->Extract(index.At(i), where);
+                }
+                else
+                {
+                    mods[i].WriteToFile(where);
+                }
+
+                timings[i] = DeployReport::FileTiming{.file = files[i], .size = size, .duration = Clock::now() - start};
+                records[i] = DeployManifest::MakeRecord(files[i], checksum, algorithm);
+            });
+
+        std::vector<size_t> ringMods;
+        std::vector<IoRing::FileWrite> batch;
+        for (size_t i = 0; i < modCount; ++i)
+        {
+            if (ringWrites[i].has_value())
+            {
+                ringMods.push_back(i);
+                batch.push_back(std::move(*ringWrites[i]));
+            }
+        }
+        if (not batch.empty())
+        {
+            // The mods are written together, so each one's time is counted from the start of the batch
+            const auto start = Clock::now();
+            IoRing ring;
+            ring.WriteFiles(batch, 
+                [&](size_t k)
+                {
+                    const auto i = ringMods[k];
+                    timings[i] = DeployReport::FileTiming{.file = files[i], .size = getSize(i), .duration = Clock::now() - start};
+                });
+            ParallelFor(ringMods.size(), options.workers, 
+                [&](size_t k)
+                {
+                    const auto i = ringMods[k];
+                    records[i] = DeployManifest::MakeRecord(files[i], checksums[i], algorithms[i]);
+                });
+        }
+    }
+    catch (...)
+    {
+        for (size_t i = 0; i < modCount; ++i)
+        {
+            if (started[i])
+            {
+                std::error_code ignored;
+                std::filesystem::remove(files[i], ignored);
+            }
+        }
+        throw;
+    }
+
+    DeployReport report;
+    auto manifest = previousManifest;
+    for (size_t i = 0; i < modCount; ++i)
+    {
+        const auto name = files[i].filename().u32string();
+        if (timings[i].has_value())
         {
-            mod.WriteToFile(where);
+            report.files.push_back(std::move(*timings[i]));
+        }
+        else
+        {
+            report.unchanged.push_back(files[i]);
+        }
+
+        if (records[i].has_value())
+        {
+            manifest.Set(name, *records[i]);
+        }
+        else
+        {
+            manifest.Remove(name);
+        }
+    }
+
+    if (options.incremental)
+    {
+        for (const auto& [name, record] : previousManifest)
+        {
+            // Only mods put there by earlier deploys are removed, anything else in the directory is left alone
+            const bool inPack = extractor.has_value() 
+                ? index.Find(name).has_value() 
+                : std::ranges::any_of(mods, [&name](const Mod& mod) { return mod.GetMetaInfo().GetName() == name; });
+            if (not inPack)
+            {
+                std::error_code ignored;
+                std::filesystem::remove(where / name, ignored);
+                report.removed.push_back(where / name);
+                manifest.Remove(name);
+            }
+        }
+    }
+
+    manifest.Save(where);
+    report.duration = Clock::now() - deployStart;
+    return report;
+}
+
+std::vector<std::u32string> MCPacker::ModPack::Verify(unsigned workers) const
+{
+    if (sourceFile.empty())
+    {
+        throw std::logic_error("Pack was not read from a file!");
+    }
+
+    const MappedFile pack(sourceFile);
+    std::vector<uint8_t> damaged(index.GetSize(), false);
+
+    ParallelFor(index.GetSize(), workers, 
+        [&](size_t i)
+        {
+            const auto& entry = index.At(i);
+            try
+            {
+                std::optional<MappedFile> blob;
+                if (entry.blob.has_value())
+                {
+                    blob.emplace(entry.GetBlobPath(blobStore.get()));
+                }
+                const auto stored = blob.has_value() 
+                    ? blob->GetRange(0, entry.size) 
+                    : pack.GetRange(entry.offset, entry.storedSize);
+                if (blob.has_value() and blob->GetContents().size() != entry.size)
+                {
+                    damaged[i] = true;
+                    return;
+                }
+                if (not entry.checksum.has_value())
+                {
+                    return;
+                }
+
+                PackIndex::Hasher hasher(entry.checksumAlgorithm);
+                uint64_t size = 0;
+                if (entry.codec == Codec::Store or blob.has_value())
+                {
+                    hasher.Update(stored);
+                    size = stored.size();
+                }
+                else
+                {
+                    // Mods are decompressed a chunk at a time, so verifying does not need memory for whole mods
+                    Decompressor decompressor(entry.codec);
+                    std::vector<Byte> output;
+                    for (size_t offset = 0; offset < stored.size(); offset += PackWriter::ChunkSize)
+                    {
+                        output.clear();
+                        decompressor.Decompress(stored.subspan(offset, std::min(PackWriter::ChunkSize, stored.size() - offset)), output, entry.size - size);
+                        hasher.Update(output);
+                        size += output.size();
+                    }
+                }
+                damaged[i] = size != entry.size or hasher.GetDigest() != *entry.checksum;
+            }
+            catch (const std::exception&)
+            {
+                damaged[i] = true;
+            }
         });
+
+    std::vector<std::u32string> damagedMods;
+    for (size_t i = 0; i < index.GetSize(); ++i)
+    {
+        if (damaged[i])
+        {
+            damagedMods.emplace_back(index.At(i).GetName());
+        }
+    }
+    return damagedMods;
+}
+
+MCPacker::DependencyResolver MCPacker::ModPack::ResolveDependencies(unsigned workers) const
+{
+    const bool fromIndex = not sourceFile.empty();
+    const size_t modCount = fromIndex ? index.GetSize() : mods.size();
+
+    // Indexes written before `PackIndex::ManifestVersion` carry no manifests, they are read from the jars,
+    // which are loaded from the file one at a time if the pack was read without mods' data
+    const bool readJars = not fromIndex or index.GetVersion() < PackIndex::ManifestVersion;
+
+    std::vector<std::string> names(modCount);
+    std::vector<std::optional<ModManifest>> manifests(modCount);
+    ParallelFor(modCount, readJars ? workers : 1, 
+        [&](size_t i)
+        {
+            names[i] = fromIndex ? index.At(i).name : mods[i].GetMetaInfo().name;
+            if (not readJars)
+            {
+                manifests[i] = index.At(i).manifest;
+            }
+            else if (fromIndex and (i >= mods.size() or mods[i].GetData().empty()))
+            {
+                manifests[i] = LoadMod(i).GetManifest();
+            }
+            else
+            {
+                manifests[i] = mods[i].GetManifest();
+            }
+        });
+    return DependencyResolver(std::move(names), std::move(manifests));
+}
+
+uint64_t MCPacker::ModPack::GetModChecksum(size_t modIndex) const
+{
+    if (sourceFile.empty())
+    {
+        const auto data = mods[modIndex].GetData();
+        return PackIndex::Checksum(data.data(), data.size());
+    }
+
+    const auto& entry = index.At(modIndex);
+    if (entry.checksum.has_value())
+    {
+        return *entry.checksum;
+    }
+
+    // Legacy packs carry no checksums, so the mod's data has to be read
+    InputBinaryFile pack(sourceFile, std::ios::binary);
+    pack.seekg(boost::numeric_cast<InputBinaryFile::off_type>(entry.offset));
+    return PackIndex::Checksum(pack, entry.size);
 }
 
 const MCPacker::ModPack::MetaInfo& MCPacker::ModPack::GetMetaInfo() const
 {
     return metaInfo;
+}
+
+const MCPacker::PackIndex& MCPacker::ModPack::GetIndex() const
+{
+    return index;
+}
+
+const std::filesystem::path& MCPacker::ModPack::GetSourceFile() const
+{
+    return sourceFile;
+}
+
+MCPacker::Mod MCPacker::ModPack::LoadMod(size_t modIndex) const
+{
+    if (sourceFile.empty())
+    {
+        throw std::logic_error("Pack was not read from a file!");
+    }
+
+    InputBinaryFile pack(sourceFile, std::ios::binary);
+    if (index.GetVersion() == PackIndex::LegacyVersion)
+    {
+        // Legacy records keep the name and size in front of the data
+        pack.seekg(boost::numeric_cast<InputBinaryFile::off_type>(index.At(modIndex).offset - Mod::MetaInfo::NameLengthInBytes - sizeof(uint64_t)));
+        return Mod(pack, ReadingMode::Full);
+    }
+    return Mod(pack, index.At(modIndex), ReadingMode::Full, blobStore.get());
+}
+
+MCPacker::Mod MCPacker::ModPack::LoadMod(std::u32string_view modName) const
+{
+    const auto modIndex = index.Find(modName);
+    if (not modIndex.has_value())
+    {
+        const auto message = format("There is no mod %1% in the pack!") % std::quoted(Utility::UTF32ToUTF8(modName));
+        throw std::invalid_argument(message.str());
+    }
+    return LoadMod(*modIndex);
 }
\ No newline at end of file
@@ -22,7 +22,11 @@
 #include <string>
 #include <string_view>
 #include <optional>
+#include <chrono>
+#include <memory>
+#include "DependencyResolver.hpp"
 #include "Mod.hpp"
+#include "PackIndex.hpp"
 
 namespace MCPacker
 {
@@ -34,29 +38,165 @@ namespace MCPacker
             static constexpr size_t NameLength = 255, DescriptionLength = 2048;
             static const std::u32string_view PackExt;
 
-            std::array<char32_t, NameLength> name;
-            std::array<char32_t, DescriptionLength> description;
+            /// @brief Pack's name and description in UTF-8 encoding, 
+            /// at most `NameLength` and `DescriptionLength` characters long
+            std::string name;
+            std::string description;
 
             MetaInfo();
-            std::string GetNameInUTF8() const;
+
+            /// @throws std::invalid_argument if the name or the description is too long
+            MetaInfo(std::u32string_view name, std::optional<std::u32string_view> description);
+            const std::string& GetNameInUTF8() const;
+
+            /// @brief Pack's name and description in UTF-32 encoding, they are converted on every call
+            std::u32string GetName() const;
+            std::u32string GetDescription() const;
+
+            /// @brief Name of the pack's `.pck` file
+            std::filesystem::path GetFileName() const;
+        };
+
+        struct DeployOptions
+        {
+            /// @brief Number of mods written concurrently, `0` means one per hardware thread
+            unsigned workers;
+
+            /// @brief Only write mods which differ from the ones already in the directory
+            /// and remove mods left there by earlier deploys which are not in the pack anymore
+            bool incremental;
+
+            /// @brief Create, write and close the mods whose data is in memory, or stored as is in the pack,
+            /// in batches through `IoRing` if the kernel supports it. The workers still decide which mods
+            /// need writing and extract the rest
+            bool ioRing;
+
+            DeployOptions();
+        };
+
+        struct IngestOptions
+        {
+            /// @brief Number of jars read concurrently, `0` means one per hardware thread.
+            /// Reading is mostly waiting on the disk, so more workers than cores still pay off
+            unsigned workers;
+
+            /// @brief Bytes of jars which are being read or wait for earlier jars to be added, at most.
+            /// The earliest jar not added yet is read regardless, so up to that many bytes plus one jar are held at once
+            uint64_t maxBytesInFlight;
+
+            ReadOptions read;
+
+            /// @brief Read the jars in batches through `IoRing` from the calling thread if the kernel supports it,
+            /// instead of by the workers. Reads bypassing the page cache always go through the workers
+            bool ioRing;
+
+            IngestOptions();
+        };
+
+        struct DeployReport
+        {
+            struct FileTiming
+            {
+                std::filesystem::path file;
+                uint64_t size;
+                std::chrono::steady_clock::duration duration;
+            };
+
+            /// @brief Timings of every written mod in the pack's order
+            std::vector<FileTiming> files;
+
+            /// @brief Mods which were already up to date in incremental mode
+            std::vector<std::filesystem::path> unchanged;
+
+            /// @brief Mods of earlier deploys removed in incremental mode
+            std::vector<std::filesystem::path> removed;
+
+            std::chrono::steady_clock::duration duration;
         };
 
     private:
         MetaInfo metaInfo;
         std::vector<Mod> mods;
 
+        /// @brief Index of the `.pck` file this pack was read from
+        PackIndex index;
+
+        /// @brief Path to the `.pck` file this pack was read from, empty if the pack was built from jars
+        std::filesystem::path sourceFile;
+
+        /// @brief Store resolving mods the pack references instead of embedding them
+        std::shared_ptr<const BlobStore> blobStore;
+
         ModPack();
 
+        void ReadIndexed(Utility::Definitions::InputBinaryFile& pack, Utility::ReadingMode readingMode);
+        void ReadLegacy(Utility::Definitions::InputBinaryFile& pack, Utility::ReadingMode readingMode);
+
+        /// @brief Checksum of the `modIndex`-th mod, computed if the pack's index does not carry it
+        uint64_t GetModChecksum(size_t modIndex) const;
+
     public:
         /// @brief Construct pack from a `.pck` file
         /// @param packFile Path to `.pck`
         /// @param readingMode Refer to `Utility::ReadingMode`
-        ModPack(std::filesystem::path packFile, Utility::ReadingMode readingMode = Utility::ReadingMode::Full);
-        ModPack(std::u32string_view name, std::optional<std::u32string_view> description, const std::vector<std::filesystem::path>& modPaths);
-        void AddMod(std::filesystem::path pathToJar);
-        void WriteToFile(std::filesystem::path where) const;
-        void Deploy(std::filesystem::path where) const;
+        /// @param blobStore Store of the mods referenced by the pack, only needed to read or deploy such mods
+        ModPack(std::filesystem::path packFile, Utility::ReadingMode readingMode = Utility::ReadingMode::Full, 
+            std::shared_ptr<const BlobStore> blobStore = nullptr);
+
+        /// @brief Construct pack from metadata of a `.pck` file read earlier, without opening the file
+        /// @details The pack behaves as one read in `Utility::ReadingMode::OnlyMetaInfo`
+        ModPack(std::filesystem::path packFile, const MetaInfo& metaInfo, PackIndex index, 
+            std::shared_ptr<const BlobStore> blobStore = nullptr);
+        ModPack(std::u32string_view name, std::optional<std::u32string_view> description, const std::vector<std::filesystem::path>& modPaths,
+            const IngestOptions& options = IngestOptions());
+
+        /// @brief Read a jar into memory and add it to the pack
+        /// @param options How to read the jar, e.g. whether huge jars bypass the page cache
+        void AddMod(std::filesystem::path pathToJar, const ReadOptions& options = ReadOptions());
+
+        /// @brief Read several jars concurrently and add them to the pack in the order of `pathsToJars`
+        /// @details If reading any of them fails, none of them is added and the first error is rethrown
+        void AddMods(const std::vector<std::filesystem::path>& pathsToJars, const IngestOptions& options = IngestOptions());
+
+        /// @brief Write the pack into directory `where`
+        /// @param compression How to compress mods' data, mods which do not get smaller are stored as is
+        /// @param blobStore Store to put mods into, the pack then only references them.
+        /// If it is `nullptr`, mods are embedded into the pack. The store's `BlobStore::Lock` is held shared while writing
+        void WriteToFile(std::filesystem::path where, const CompressionOptions& compression = CompressionOptions(), 
+            const BlobStore* blobStore = nullptr) const;
+
+        /// @brief Write every mod of the pack into `where`
+        /// @details Mods are written by `options.workers` threads. If writing any of them fails,
+        /// the mods written by this call are removed and the first error is rethrown.
+        /// A successful deploy records what it wrote in `where`'s `DeployManifest`
+        DeployReport Deploy(std::filesystem::path where, const DeployOptions& options = DeployOptions()) const;
+
+        /// @brief Check every mod of the `.pck` file this pack was read from against its checksum
+        /// @details Mods are hashed by `workers` threads, 0 meaning one per hardware thread.
+        /// Mods lying outside of the file, missing from the blob store or failing to decompress count as damaged,
+        /// mods without a checksum, as in legacy packs, are only checked for being within the file
+        /// @return Names of the damaged mods in the index's order
+        std::vector<std::u32string> Verify(unsigned workers = 0) const;
+
+        /// @brief Build the dependency graph of the pack's mods and find missing dependencies, conflicts and duplicates
+        /// @details Manifests come from the pack's index. They are read from the jars instead by `workers` threads,
+        /// 0 meaning one per hardware thread, for packs built from jars and for packs whose index predates manifests.
+        /// Mods of the latter whose data is not in memory, as in `ReadingMode::OnlyMetaInfo`, are loaded from the file one by one
+        DependencyResolver ResolveDependencies(unsigned workers = 0) const;
         const MetaInfo& GetMetaInfo() const;
+        const PackIndex& GetIndex() const;
+
+        /// @brief Path to the `.pck` file this pack was read from, empty if the pack was built from jars
+        const std::filesystem::path& GetSourceFile() const;
+
+        /// @brief Read a single mod from the `.pck` file this pack was read from
+        /// @param modIndex Position of the mod in the pack's index
+        /// @details Only the requested mod's data is read, which is useful for packs read in `ReadingMode::OnlyMetaInfo`
+        Mod LoadMod(size_t modIndex) const;
+
+        /// @brief Read a single mod from the `.pck` file this pack was read from
+        /// @param modName Name of the mod's `.jar` file
+        Mod LoadMod(std::u32string_view modName) const;
     };
 }
 
@@ -1,17 +1,224 @@
+#include <algorithm>
+#include <set>
+#include <optional>
 #include "ModPackManager.hpp"
+#include "PackCache.hpp"
+#include "ParallelFor.hpp"
+
+namespace
+{
+    bool IsPackFile(const std::filesystem::path& path)
+    {
+        return path.extension().u32string() == MCPacker::ModPack::MetaInfo::PackExt;
+    }
+}
+
+bool MCPacker::ModPackManager::Progress::IsComplete() const
+{
+    return loaded == total;
+}
 
 MCPacker::ModPackManager::ModPackManager()
     :
     pathToPacks(std::filesystem::path(".") / std::filesystem::path("packs")),
-    detectedModPacks()
+    blobStore(std::make_shared<const BlobStore>(pathToPacks / "blobs")),
+    detectedModPacks(),
+    loaded(false),
+    updateMutex(),
+    listenersMutex(),
+    listeners(),
+    nextListenerId(0),
+    progress{.loaded = 0, .total = 0},
+    watcher(),
+    discoveryThread()
+{
+    // The watcher records changes from now on, so nothing changed while discovering is missed
+    watcher.emplace(pathToPacks);
+    auto packFiles = FindPackFiles();
+    Publish(std::make_shared<const ModPackList>(), Progress{.loaded = 0, .total = packFiles.size()});
+
+    discoveryThread = std::jthread(
+        [this, packFiles = std::move(packFiles)](std::stop_token stopToken)
+        {
+            {
+                std::scoped_lock lock(updateMutex);
+                Discover(packFiles, true, stopToken);
+            }
+            if (not stopToken.stop_requested())
+            {
+                watcher->Start(
+                    [this](const std::vector<std::filesystem::path>& changed, bool rescan)
+                    {
+                        Update(changed, rescan);
+                    });
+            }
+        });
+}
+
+std::vector<std::filesystem::path> MCPacker::ModPackManager::FindPackFiles() const
 {
+    std::vector<std::filesystem::path> packFiles;
+    std::error_code error;
+    if (not std::filesystem::is_directory(pathToPacks, error))
+    {
+        // The directory was removed while watched, so it has no packs until it comes back
+        return packFiles;
+    }
     for (const auto& entry : std::filesystem::directory_iterator(pathToPacks))
     {
-        if (entry.is_regular_file() and 
-            entry.path().extension().u32string() == MCPacker::ModPack::MetaInfo::PackExt)
+        if (entry.is_regular_file() and IsPackFile(entry.path()))
+        {
+            packFiles.push_back(entry.path());
+        }
+    }
+    return packFiles;
+}
+
+void MCPacker::ModPackManager::Discover(const std::vector<std::filesystem::path>& packFiles, bool progressive, std::stop_token stopToken)
+{
+    const auto cache = PackCache::Load(pathToPacks);
+    PackCache updatedCache;
+    ModPackList modPacks;
+    size_t hits = 0;
+
+    for (size_t first = 0; first < packFiles.size(); first += BatchSize)
+    {
+        if (stopToken.stop_requested())
+        {
+            return;
+        }
+
+        const auto batchSize = std::min(BatchSize, packFiles.size() - first);
+        std::vector<std::optional<ModPack>> packs(batchSize);
+        std::vector<std::optional<PackCache::FileStatus>> statuses(batchSize);
+        std::vector<uint8_t> cached(batchSize, false);
+        ParallelFor(batchSize, 0, 
+            [&](size_t i)
+            {
+                const auto& packFile = packFiles[first + i];
+                statuses[i] = PackCache::Stat(packFile);
+                if (statuses[i].has_value())
+                {
+                    packs[i] = cache.Find(packFile, *statuses[i], blobStore);
+                }
+                cached[i] = packs[i].has_value();
+                if (not cached[i])
+                {
+                    try
+                    {
+                        packs[i].emplace(packFile, Utility::ReadingMode::OnlyMetaInfo, blobStore);
+                    }
+                    catch (const std::exception&)
+                    {
+                        // A pack which cannot be read is left out until it is written again
+                    }
+                }
+            });
+
+        for (size_t i = 0; i < batchSize; ++i)
+        {
+            if (packs[i].has_value())
+            {
+                if (statuses[i].has_value())
+                {
+                    updatedCache.Set(packFiles[first + i], *statuses[i], *packs[i]);
+                }
+                modPacks.push_back(std::make_shared<const ModPack>(std::move(*packs[i])));
+            }
+        }
+        hits += static_cast<size_t>(std::ranges::count(cached, true));
+
+        if (progressive or first + batchSize == packFiles.size())
+        {
+            Publish(std::make_shared<const ModPackList>(modPacks), Progress{.loaded = first + batchSize, .total = packFiles.size()});
+        }
+    }
+    if (packFiles.empty() and not progressive)
+    {
+        Publish(std::make_shared<const ModPackList>(), Progress{.loaded = 0, .total = 0});
+    }
+
+    // Packs which were read, or removed since the last run, make the cache stale
+    if (hits != packFiles.size() or hits != cache.GetSize())
+    {
+        try
+        {
+            updatedCache.Save(pathToPacks);
+        }
+        catch (const std::exception&)
+        {
+            // A cache which cannot be written only costs reading the packs on the next run
+        }
+    }
+}
+
+void MCPacker::ModPackManager::Update(const std::vector<std::filesystem::path>& changed, bool rescan)
+{
+    std::scoped_lock lock(updateMutex);
+    try
+    {
+        if (rescan)
+        {
+            Discover(FindPackFiles(), false);
+            return;
+        }
+
+        std::set<std::filesystem::path> changedPacks;
+        std::ranges::copy_if(changed, std::inserter(changedPacks, std::end(changedPacks)), IsPackFile);
+        if (changedPacks.empty())
         {
-            detectedModPacks.emplace_back(entry.path(), Utility::ReadingMode::OnlyMetaInfo);
+            return;
         }
+
+        // Unchanged packs are shared with the previous list, only the changed ones are read again
+        const auto current = detectedModPacks.load();
+        ModPackList modPacks;
+        std::ranges::copy_if(*current, std::back_inserter(modPacks), 
+            [&changedPacks](const std::shared_ptr<const ModPack>& modPack)
+            {
+                return not changedPacks.contains(modPack->GetSourceFile());
+            });
+
+        for (const auto& packFile : changedPacks)
+        {
+            std::error_code error;
+            if (not std::filesystem::is_regular_file(packFile, error))
+            {
+                continue;
+            }
+            try
+            {
+                modPacks.push_back(std::make_shared<const ModPack>(packFile, Utility::ReadingMode::OnlyMetaInfo, blobStore));
+            }
+            catch (const std::exception&)
+            {
+                // A pack which cannot be read is left out until it is written again
+            }
+        }
+        const Progress complete{.loaded = modPacks.size(), .total = modPacks.size()};
+        Publish(std::make_shared<const ModPackList>(std::move(modPacks)), complete);
+    }
+    catch (const std::exception&)
+    {
+        // The previous list stays published, the next change gets another chance
+    }
+}
+
+void MCPacker::ModPackManager::Publish(std::shared_ptr<const ModPackList> modPacks, Progress progress)
+{
+    detectedModPacks.store(modPacks);
+
+    std::scoped_lock lock(listenersMutex);
+    this->progress = progress;
+    for (const auto& [id, listener] : listeners)
+    {
+        listener(modPacks, progress);
+    }
+
+    if (progress.IsComplete() and not loaded)
+    {
+        loaded = true;
+        loaded.notify_all();
     }
 }
 
@@ -21,7 +228,59 @@ const MCPacker::ModPackManager& MCPacker::ModPackManager::Instance()
     return instance;
 }
 
-const std::vector<MCPacker::ModPack>& MCPacker::ModPackManager::GetModPacks() const
+std::shared_ptr<const MCPacker::ModPackManager::ModPackList> MCPacker::ModPackManager::GetModPacks() const
 {
-    return detectedModPacks;
+    return detectedModPacks.load();
 }
+
+MCPacker::ModPackManager::Progress MCPacker::ModPackManager::GetProgress() const
+{
+    std::scoped_lock lock(listenersMutex);
+    return progress;
+}
+
+void MCPacker::ModPackManager::WaitUntilLoaded() const
+{
+    loaded.wait(false);
+}
+
+size_t MCPacker::ModPackManager::Subscribe(Listener listener) const
+{
+    std::scoped_lock lock(listenersMutex);
+    listener(detectedModPacks.load(), progress);
+    listeners.emplace(nextListenerId, std::move(listener));
+    return nextListenerId++;
+}
+
+void MCPacker::ModPackManager::Unsubscribe(size_t listenerId) const
+{
+    std::scoped_lock lock(listenersMutex);
+    listeners.erase(listenerId);
+}
+
+std::shared_ptr<const MCPacker::BlobStore> MCPacker::ModPackManager::GetBlobStore() const
+{
+    return blobStore;
+}
+
+std::vector<std::filesystem::path> MCPacker::ModPackManager::CollectGarbage() const
+{
+    // Packs being written hold the lock shared, so every blob they put is referenced by a pack by the time it is acquired
+    const BlobStore::Lock lock(*blobStore, BlobStore::Lock::Mode::Exclusive);
+    std::set<BlobStore::Digest> referenced;
+    for (const auto& entry : std::filesystem::directory_iterator(pathToPacks))
+    {
+        if (entry.is_regular_file() and IsPackFile(entry.path()))
+        {
+            const ModPack pack(entry.path(), Utility::ReadingMode::OnlyMetaInfo);
+            for (const auto& modEntry : pack.GetIndex())
+            {
+                if (modEntry.blob.has_value())
+                {
+                    referenced.insert(*modEntry.blob);
+                }
+            }
+        }
+    }
+    return blobStore->CollectGarbage(referenced);
+}
\ No newline at end of file
@@ -1,25 +1,108 @@
 #ifndef MOD_PACK_MANAGER_HPP
 #define MOD_PACK_MANAGER_HPP
 
+#include <atomic>
 #include <filesystem>
+#include <functional>
+#include <map>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <boost/noncopyable.hpp>
 #include "ModPack.hpp"
+#include "DirectoryWatcher.hpp"
 
 namespace MCPacker
 {
+    /// @brief Packs found in the `packs` directory
+    /// @details Packs are read concurrently on a background thread, and their metadata is cached in a `PackCache`,
+    /// so packs which have not changed since the last run are not opened at all. The list grows in batches
+    /// while packs are being read, packs which cannot be read are left out.
+    /// The directory is watched afterwards: only packs which are written, replaced or removed are
+    /// re-read, and every change publishes a new list, so readers holding the old one are never disturbed
     class ModPackManager final : private boost::noncopyable
     {
+    public:
+        using ModPackList = std::vector<std::shared_ptr<const ModPack>>;
+
+        /// @brief Number of packs read out of the ones found in the directory
+        struct Progress
+        {
+            size_t loaded;
+            size_t total;
+
+            bool IsComplete() const;
+        };
+
+        /// @brief Called on a background thread with every published list.
+        /// It must be quick and must not subscribe or unsubscribe listeners
+        using Listener = std::function<void(const std::shared_ptr<const ModPackList>& modPacks, Progress progress)>;
+
+        /// @brief Number of packs read between publishing lists while discovering packs
+        static constexpr size_t BatchSize = 32;
+
     private:
         std::filesystem::path pathToPacks;
-        std::vector<ModPack> detectedModPacks;
+        std::shared_ptr<const BlobStore> blobStore;
+        std::atomic<std::shared_ptr<const ModPackList>> detectedModPacks;
+        std::atomic<bool> loaded;
+
+        /// @brief Serialises updates of the list, readers never take it
+        std::mutex updateMutex;
+
+        /// @brief Guards listeners and the progress they are told about
+        mutable std::mutex listenersMutex;
+        mutable std::map<size_t, Listener> listeners;
+        mutable size_t nextListenerId;
+        Progress progress;
+
+        std::optional<DirectoryWatcher> watcher;
+        std::jthread discoveryThread;
 
         ModPackManager();
 
+        std::vector<std::filesystem::path> FindPackFiles() const;
+
+        /// @brief Read `packFiles`, reusing cached metadata of unchanged ones, and publish the list
+        /// @param progressive Publish the list after every batch rather than only once every pack is read
+        void Discover(const std::vector<std::filesystem::path>& packFiles, bool progressive, std::stop_token stopToken = {});
+
+        /// @brief Re-read the packs at `changed` and publish the updated list
+        /// @param rescan Read every pack in the directory again instead
+        void Update(const std::vector<std::filesystem::path>& changed, bool rescan);
+
+        void Publish(std::shared_ptr<const ModPackList> modPacks, Progress progress);
+
     public:
         static const ModPackManager& Instance();
 
-        const std::vector<ModPack>& GetModPacks() const;
+        /// @brief Current list of packs, it is never modified once published
+        std::shared_ptr<const ModPackList> GetModPacks() const;
+
+        Progress GetProgress() const;
+
+        /// @brief Block until the packs found at startup have been read
+        void WaitUntilLoaded() const;
+
+        /// @brief Start telling `listener` about published lists
+        /// @details The listener is called with the current list right away, so nothing published before is missed
+        /// @return Identifier to unsubscribe the listener with
+        size_t Subscribe(Listener listener) const;
+
+        /// @brief Stop telling the listener about published lists, it is not running anymore once this returns
+        void Unsubscribe(size_t listenerId) const;
+
+        /// @brief Store shared by the packs, it lives in the `blobs` subdirectory of the packs' directory
+        std::shared_ptr<const BlobStore> GetBlobStore() const;
+
+        /// @brief Remove blobs that no pack in the packs' directory references anymore
+        /// @details Packs are rescanned, so ones created since the manager was constructed are accounted for.
+        /// Writing packs into the store, in this or another process, waits until collecting is done and vice versa
+        /// @throws std::runtime_error if some pack cannot be read, nothing is removed in that case
+        /// @return Paths of the removed blobs
+        std::vector<std::filesystem::path> CollectGarbage() const;
     };
 }
 
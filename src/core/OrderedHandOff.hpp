@@ -0,0 +1,92 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ORDERED_HAND_OFF_HPP
+#define ORDERED_HAND_OFF_HPP
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace MCPacker
+{
+    /// @brief Hands items which are finished in any order over in the order of their indices,
+    /// keeping the bytes of the items admitted but not handed over yet within a budget
+    /// @details The earliest item not handed over yet is always admitted, otherwise it could wait forever
+    /// for the budget held by the items after it, so up to the budget plus one item are held at once.
+    /// Callers serialise access to it
+    template<typename T>
+    class OrderedHandOff
+    {
+    private:
+        /// @brief Items which are finished but wait for earlier ones
+        std::vector<std::optional<T>> slots;
+
+        /// @brief Bytes each admitted item takes from the budget
+        std::vector<uint64_t> sizes;
+        uint64_t maxBytesInFlight;
+        uint64_t bytesInFlight;
+        size_t nextToHandOver;
+
+    public:
+        OrderedHandOff(size_t count, uint64_t maxBytesInFlight)
+            :
+            slots(count),
+            sizes(count),
+            maxBytesInFlight(maxBytesInFlight),
+            bytesInFlight(0),
+            nextToHandOver(0)
+        {
+        }
+
+        /// @brief Whether item `i` of `size` bytes can be admitted now
+        bool CanAdmit(size_t i, uint64_t size) const
+        {
+            return i == nextToHandOver or bytesInFlight + size <= maxBytesInFlight;
+        }
+
+        /// @brief Take `size` bytes of the budget for item `i` until it is handed over
+        void Admit(size_t i, uint64_t size)
+        {
+            sizes[i] = size;
+            bytesInFlight += size;
+        }
+
+        /// @brief Keep finished item `i` and hand over every item which is next in order
+        /// @param handOver Called as `handOver(index, item)`, the item's bytes are back in the budget by then
+        /// @return Number of items handed over
+        template<typename HandOver>
+        size_t Finish(size_t i, T item, HandOver&& handOver)
+        {
+            slots[i].emplace(std::move(item));
+            size_t handedOver = 0;
+            while (nextToHandOver < slots.size() and slots[nextToHandOver].has_value())
+            {
+                const auto current = nextToHandOver++;
+                auto finished = std::move(*slots[current]);
+                slots[current].reset();
+                bytesInFlight -= sizes[current];
+                ++handedOver;
+                handOver(current, std::move(finished));
+            }
+            return handedOver;
+        }
+    };
+}
+
+#endif //ORDERED_HAND_OFF_HPP
\ No newline at end of file
@@ -0,0 +1,154 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <iomanip>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <boost/format.hpp>
+#include "PackBuilder.hpp"
+#include "FileReader.hpp"
+#include "PackWriter.hpp"
+#include "ParallelFor.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+MCPacker::PackBuilder::PackBuilder(std::u32string_view name, std::optional<std::u32string_view> description)
+    :
+    metaInfo(name, description),
+    modPaths()
+{
+
+}
+
+MCPacker::PackBuilder::PackBuilder(std::u32string_view name, std::optional<std::u32string_view> description, const std::vector<fs::path>& modPaths)
+    :
+    PackBuilder(name, description)
+{
+    std::ranges::for_each(modPaths, 
+        [this](const auto& path)
+        {
+            AddMod(path);
+        });
+}
+
+void MCPacker::PackBuilder::AddMod(fs::path pathToJar)
+{
+    if (not fs::is_regular_file(pathToJar))
+    {
+        const auto message = format("File %1% does not exist!") % std::quoted(pathToJar.string());
+        throw std::invalid_argument(message.str());
+    }
+    if (pathToJar.filename().u32string().size() > PackIndex::NameLength)
+    {
+        const auto message = format("Name of file %1% is too long!") % std::quoted(pathToJar.filename().string());
+        throw std::invalid_argument(message.str());
+    }
+    modPaths.push_back(std::move(pathToJar));
+}
+
+fs::path MCPacker::PackBuilder::WriteToFile(fs::path where, const CompressionOptions& compression, const BlobStore* blobStore) const
+{
+    if (not fs::is_directory(where))
+    {
+        const auto message = format("Path %1% is not a directory!") % std::quoted(where.string());
+        throw std::invalid_argument(message.str());
+    }
+    where /= metaInfo.GetFileName();
+
+    std::vector<PackWriter::ModName> modNames;
+    modNames.reserve(modPaths.size());
+    std::ranges::transform(modPaths, std::back_inserter(modNames), 
+        [](const fs::path& path)
+        {
+            return Utility::UTF32ToUTF8(path.filename().u32string());
+        });
+
+    // Only the central directory and the metadata file of each jar are read here, the data is streamed later
+    std::vector<std::optional<ModManifest>> manifests(modPaths.size());
+    ParallelFor(modPaths.size(), compression.workers, 
+        [&](size_t i)
+        {
+            InputBinaryFile jar(modPaths[i], std::ios::binary);
+            if (jar.is_open())
+            {
+                manifests[i] = ModManifest::Read(jar);
+            }
+        });
+
+    // The blobs are only referenced once the pack is in place, so garbage collection has to wait until then
+    std::optional<BlobStore::Lock> lock;
+    if (blobStore != nullptr)
+    {
+        lock.emplace(*blobStore, BlobStore::Lock::Mode::Shared);
+    }
+
+    PackWriter writer(where, metaInfo, std::move(modNames), compression, std::move(manifests));
+    const auto workerCount = ResolveWorkerCount(compression.workers, modPaths.size());
+    if (blobStore == nullptr and compression.codec != Codec::Store)
+    {
+        // Compression is what takes time, so jars are read a batch at a time and compressed by the writer's workers.
+        // Streamed mods would be compressed into different frames, so this is done for a single worker too,
+        // which keeps the pack the same for any number of workers
+        for (size_t next = 0; next < modPaths.size(); )
+        {
+            std::vector<std::vector<Byte>> batch;
+            uint64_t batchSize = 0;
+            while (next < modPaths.size() and batch.size() < 2 * workerCount and (batch.empty() or batchSize < MaxBatchSize))
+            {
+                FileReader jar(modPaths[next++]);
+                batchSize += jar.GetSize();
+                batch.push_back(jar.ReadAll());
+            }
+
+            writer.Append(std::vector<std::span<const Byte>>(std::begin(batch), std::end(batch)));
+        }
+        writer.Finish();
+        return where;
+    }
+
+    std::ranges::for_each(modPaths, 
+        [&writer, blobStore](const fs::path& path)
+        {
+            InputBinaryFile jar(path, std::ios::binary);
+            if (not jar.is_open())
+            {
+                const auto message = format("Unable to read file %1%!") % path.filename().string();
+                throw std::runtime_error(message.str());
+            }
+            if (blobStore != nullptr)
+            {
+                writer.AppendReference(jar, *blobStore);
+            }
+            else
+            {
+                writer.Append(jar);
+            }
+        });
+    writer.Finish();
+
+    return where;
+}
+
+const MCPacker::ModPack::MetaInfo& MCPacker::PackBuilder::GetMetaInfo() const
+{
+    return metaInfo;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACK_BUILDER_HPP
+#define PACK_BUILDER_HPP
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "ModPack.hpp"
+
+namespace MCPacker
+{
+    /// @brief Builds a `.pck` file from `.jar` files without loading them into memory
+    /// @details Unlike `ModPack`, which holds every mod's data, the builder only remembers paths to the jars
+    /// and streams them into the pack in chunks of `PackWriter::ChunkSize` bytes, so memory used
+    /// while writing does not depend on the size of the pack.
+    /// When mods are compressed, the jars are instead read a batch at a time, up to twice as many jars
+    /// as workers and `MaxBatchSize` bytes, and a batch is held in memory while the workers compress it
+    class PackBuilder
+    {
+    public:
+        /// @brief Bytes of jars read into one batch at most, a jar larger than that makes a batch of its own
+        static constexpr uint64_t MaxBatchSize = 256 << 20;
+
+    private:
+        ModPack::MetaInfo metaInfo;
+        std::vector<std::filesystem::path> modPaths;
+
+    public:
+        PackBuilder(std::u32string_view name, std::optional<std::u32string_view> description);
+        PackBuilder(std::u32string_view name, std::optional<std::u32string_view> description, const std::vector<std::filesystem::path>& modPaths);
+
+        /// @brief Add a mod to the pack, the jar is not read until `WriteToFile`
+        /// @throws std::invalid_argument if the jar does not exist
+        void AddMod(std::filesystem::path pathToJar);
+
+        /// @brief Write the pack into directory `where`
+        /// @param compression How to compress mods' data, mods which do not get smaller are stored as is.
+        /// Its workers read the jars' manifests and, unless the mods are put into `blobStore`, compress them
+        /// @param blobStore Store to put mods into, the pack then only references them.
+        /// If it is `nullptr`, mods are embedded into the pack. The store's `BlobStore::Lock` is held shared while writing
+        /// @return Path to the written `.pck` file
+        std::filesystem::path WriteToFile(std::filesystem::path where, const CompressionOptions& compression = CompressionOptions(), 
+            const BlobStore* blobStore = nullptr) const;
+
+        const ModPack::MetaInfo& GetMetaInfo() const;
+    };
+}
+
+#endif //PACK_BUILDER_HPP
\ No newline at end of file
@@ -0,0 +1,208 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <iomanip>
+#include <boost/format.hpp>
+#include "PackCache.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    template<typename T>
+    bool ReadNumber(InputBinaryFile& file, T& value)
+    {
+        std::array<Byte, sizeof(T)> serialised;
+        file.read(serialised.data(), serialised.size());
+        value = MCPacker::Utility::FromByteArray<T>(serialised);
+        return static_cast<bool>(file);
+    }
+
+    bool ReadString(InputBinaryFile& file, std::string& value)
+    {
+        uint32_t size = 0;
+        if (not ReadNumber(file, size))
+        {
+            return false;
+        }
+        value.assign(size, '\0');
+        file.read(value.data(), value.size());
+        return file and MCPacker::Utility::IsValidUTF8(value);
+    }
+
+    void WriteString(OutputBinaryFile& file, std::string_view value)
+    {
+        std::ranges::copy(MCPacker::Utility::ToByteArray(static_cast<uint32_t>(value.size())), std::ostreambuf_iterator(file));
+        std::ranges::copy(value, std::ostreambuf_iterator(file));
+    }
+
+    /// @brief Restore the index of a pack of `version` which was cached in the current layout
+    MCPacker::PackIndex Restore(const MCPacker::PackIndex& cached, uint16_t version)
+    {
+        using MCPacker::PackIndex;
+
+        PackIndex index(version);
+        for (auto entry : cached)
+        {
+            entry.checksumAlgorithm = PackIndex::ChecksumAlgorithmOf(version);
+            if (version == PackIndex::LegacyVersion)
+            {
+                entry.checksum.reset();
+            }
+            index.Add(std::move(entry));
+        }
+        return index;
+    }
+}
+
+MCPacker::PackCache MCPacker::PackCache::Load(const fs::path& directory)
+{
+    PackCache cache;
+
+    InputBinaryFile file(directory / FileName, std::ios::binary);
+    if (not file.is_open())
+    {
+        return cache;
+    }
+
+    // Indices are cached in the current layout, so a cache written by another version of the format is stale
+    std::array<Byte, Magic.size()> magic;
+    uint16_t version = 0, indexVersion = 0;
+    uint64_t recordCount = 0;
+    file.read(magic.data(), magic.size());
+    if (not file or magic != Magic or not ReadNumber(file, version) or version != CurrentVersion 
+        or not ReadNumber(file, indexVersion) or indexVersion != PackIndex::CurrentVersion
+        or not ReadNumber(file, recordCount))
+    {
+        // A stale cache only costs reading the packs again, so it is just ignored
+        return cache;
+    }
+
+    try
+    {
+        for (uint64_t i = 0; i < recordCount; ++i)
+        {
+            std::string fileName;
+            uint16_t packVersion = 0;
+            Record record{.size = 0, .modificationTime = 0, .metaInfo = {}, .index = {}};
+            if (not ReadString(file, fileName) or not ReadNumber(file, record.size) or not ReadNumber(file, record.modificationTime)
+                or not ReadString(file, record.metaInfo.name) or not ReadString(file, record.metaInfo.description) 
+                or not ReadNumber(file, packVersion))
+            {
+                return PackCache();
+            }
+
+            record.index = Restore(PackIndex::Read(file, PackIndex::CurrentVersion), packVersion);
+            cache.records.insert_or_assign(fs::path(fileName), std::move(record));
+        }
+    }
+    catch (const std::exception&)
+    {
+        return PackCache();
+    }
+
+    return cache;
+}
+
+void MCPacker::PackCache::Save(const fs::path& directory) const
+{
+    const auto path = directory / FileName;
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+
+    {
+        OutputBinaryFile file(temporaryPath, std::ios::binary | std::ios::trunc);
+        std::ranges::copy(Magic, std::ostreambuf_iterator(file));
+        std::ranges::copy(Utility::ToByteArray(CurrentVersion), std::ostreambuf_iterator(file));
+        std::ranges::copy(Utility::ToByteArray(PackIndex::CurrentVersion), std::ostreambuf_iterator(file));
+        std::ranges::copy(Utility::ToByteArray(static_cast<uint64_t>(records.size())), std::ostreambuf_iterator(file));
+        for (const auto& [fileName, record] : records)
+        {
+            WriteString(file, fileName.string());
+            std::ranges::copy(Utility::ToByteArray(record.size), std::ostreambuf_iterator(file));
+            std::ranges::copy(Utility::ToByteArray(record.modificationTime), std::ostreambuf_iterator(file));
+            WriteString(file, record.metaInfo.name);
+            WriteString(file, record.metaInfo.description);
+            std::ranges::copy(Utility::ToByteArray(record.index.GetVersion()), std::ostreambuf_iterator(file));
+
+            const auto encodedIndex = record.index.Encode();
+            file.write(encodedIndex.data(), static_cast<std::streamsize>(encodedIndex.size()));
+        }
+
+        file.close();
+        if (not file)
+        {
+            const auto message = format("Unable to write file %1%!") % std::quoted(temporaryPath.string());
+            throw std::runtime_error(message.str());
+        }
+    }
+
+    fs::rename(temporaryPath, path);
+}
+
+std::optional<MCPacker::PackCache::FileStatus> MCPacker::PackCache::Stat(const fs::path& packFile)
+{
+    std::error_code error;
+    const auto size = fs::file_size(packFile, error);
+    if (error)
+    {
+        return std::nullopt;
+    }
+    const auto modificationTime = fs::last_write_time(packFile, error);
+    if (error)
+    {
+        return std::nullopt;
+    }
+    return FileStatus{.size = size, .modificationTime = static_cast<int64_t>(modificationTime.time_since_epoch().count())};
+}
+
+std::optional<MCPacker::ModPack> MCPacker::PackCache::Find(const fs::path& packFile, const FileStatus& status, 
+    std::shared_ptr<const BlobStore> blobStore) const
+{
+    const auto record = records.find(packFile.filename());
+    if (record == std::end(records))
+    {
+        return std::nullopt;
+    }
+
+    if (status.size != record->second.size or status.modificationTime != record->second.modificationTime)
+    {
+        return std::nullopt;
+    }
+    return ModPack(packFile, record->second.metaInfo, record->second.index, std::move(blobStore));
+}
+
+void MCPacker::PackCache::Set(const fs::path& packFile, const FileStatus& status, const ModPack& pack)
+{
+    records.insert_or_assign(packFile.filename(), Record{
+        .size = status.size, 
+        .modificationTime = status.modificationTime, 
+        .metaInfo = pack.GetMetaInfo(), 
+        .index = pack.GetIndex()
+    });
+}
+
+size_t MCPacker::PackCache::GetSize() const
+{
+    return records.size();
+}
\ No newline at end of file
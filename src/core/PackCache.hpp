@@ -0,0 +1,97 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACK_CACHE_HPP
+#define PACK_CACHE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <Utility.hpp>
+#include "ModPack.hpp"
+#include "PackIndex.hpp"
+
+namespace MCPacker
+{
+    /// @brief Metadata of the packs in a directory, kept on disk between runs
+    /// @details The cache is kept next to the packs and remembers the name, description and index
+    /// of every pack along with the size and modification time of its file, so packs which
+    /// have not changed since are listed without opening them
+    class PackCache
+    {
+    public:
+        static constexpr std::string_view FileName = ".mcpacker-cache";
+        static constexpr std::array<Utility::Definitions::Byte, 8> Magic = {'\x89', 'M', 'C', 'P', 'C', 'C', '\r', '\n'};
+        static constexpr uint16_t CurrentVersion = 2;
+
+        /// @brief What tells whether a pack's file has changed
+        struct FileStatus
+        {
+            uint64_t size;
+
+            /// @brief `std::filesystem::last_write_time` of the pack as a count of ticks
+            int64_t modificationTime;
+        };
+
+        struct Record
+        {
+            uint64_t size;
+
+            /// @brief `std::filesystem::last_write_time` of the pack as a count of ticks
+            int64_t modificationTime;
+
+            ModPack::MetaInfo metaInfo;
+            PackIndex index;
+        };
+
+    private:
+        /// @brief Records by file name of the pack
+        /// @details The cache belongs to the directory of the packs, so the name is all that tells them apart,
+        /// however the directory was spelled by whoever read them
+        std::map<std::filesystem::path, Record> records;
+
+    public:
+        /// @brief Read the cache of `directory`
+        /// @return Cache with no records if there is none or it cannot be read
+        static PackCache Load(const std::filesystem::path& directory);
+
+        /// @brief Replace the cache of `directory` with this one
+        void Save(const std::filesystem::path& directory) const;
+
+        /// @brief Size and modification time of `packFile`
+        /// @return `std::nullopt` if the file cannot be stat'ed
+        static std::optional<FileStatus> Stat(const std::filesystem::path& packFile);
+
+        /// @brief Make a pack of `packFile` from the record of its file name
+        /// @param status Status of the file, see `Stat`
+        /// @return `std::nullopt` if there is no record of the file or the file has changed since
+        std::optional<ModPack> Find(const std::filesystem::path& packFile, const FileStatus& status, 
+            std::shared_ptr<const BlobStore> blobStore = nullptr) const;
+
+        /// @brief Record metadata of `pack` read from `packFile` under its file name
+        /// @param status Status of the file taken before `pack` was read from it, so a file replaced
+        /// in the meantime is read again next time rather than paired with the stale metadata
+        void Set(const std::filesystem::path& packFile, const FileStatus& status, const ModPack& pack);
+
+        size_t GetSize() const;
+    };
+}
+
+#endif //PACK_CACHE_HPP
\ No newline at end of file
@@ -0,0 +1,282 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdexcept>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/format.hpp>
+#include "PackExtractor.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+namespace
+{
+    /// @brief Size of the buffer used when the kernel cannot copy for us
+    constexpr size_t BufferSize = 1 << 20;
+
+    /// @brief Largest amount of bytes a single `copy_file_range` or `sendfile` call transfers on Linux
+    constexpr uint64_t MaxChunkSize = 0x7ffff000;
+
+    /// @brief Errors meaning the method cannot be used for this pair of files, rather than an I/O failure
+    bool IsUnsupported(int error)
+    {
+        return error == ENOSYS or error == EXDEV or error == EINVAL or error == EOPNOTSUPP or error == EBADF;
+    }
+
+    void WriteAll(int fd, std::span<const Byte> data)
+    {
+        while (not data.empty())
+        {
+            const auto written = write(fd, data.data(), data.size());
+            if (written == -1)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::runtime_error((format("Unable to write mod's data: %1%") % std::strerror(errno)).str());
+            }
+            data = data.subspan(static_cast<size_t>(written));
+        }
+    }
+}
+
+MCPacker::PackExtractor::PackExtractor(const fs::path& packFile, const BlobStore* blobStore)
+    :
+    packFd(open(packFile.c_str(), O_RDONLY | O_CLOEXEC)),
+    packSize(0),
+    blobStore(blobStore),
+    method(Method::CopyFileRange)
+{
+    if (packFd == -1)
+    {
+        const auto message = format("Unable to open file %1%: %2%") % std::quoted(packFile.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+
+    struct stat status;
+    if (fstat(packFd, &status) == -1)
+    {
+        const auto message = format("Unable to stat file %1%: %2%") % std::quoted(packFile.string()) % std::strerror(errno);
+        close(packFd);
+        throw std::runtime_error(message.str());
+    }
+    packSize = static_cast<uint64_t>(status.st_size);
+}
+
+MCPacker::PackExtractor::~PackExtractor()
+{
+    close(packFd);
+}
+
+bool MCPacker::PackExtractor::CopyWith(Method method, int sourceFd, int jarFd, uint64_t& offset, uint64_t& remaining) const
+{
+    while (remaining != 0)
+    {
+        const auto chunk = static_cast<size_t>(std::min(remaining, MaxChunkSize));
+        ssize_t copied = -1;
+
+        switch (method)
+        {
+            case Method::CopyFileRange:
+            {
+                auto sourceOffset = static_cast<off64_t>(offset);
+                copied = copy_file_range(sourceFd, &sourceOffset, jarFd, nullptr, chunk, 0);
+                break;
+            }
+
+            case Method::SendFile:
+            {
+                auto sourceOffset = static_cast<off_t>(offset);
+                copied = sendfile(jarFd, sourceFd, &sourceOffset, chunk);
+                break;
+            }
+
+            case Method::Buffered:
+            {
+                thread_local std::vector<Byte> buffer(BufferSize);
+                copied = pread(sourceFd, buffer.data(), std::min(chunk, buffer.size()), static_cast<off_t>(offset));
+                if (copied > 0)
+                {
+                    WriteAll(jarFd, std::span(buffer).first(static_cast<size_t>(copied)));
+                }
+                break;
+            }
+        }
+
+        if (copied == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // Both offsets have advanced by what was copied so far, so the next method picks up from there
+            if (method != Method::Buffered and IsUnsupported(errno))
+            {
+                return false;
+            }
+            throw std::runtime_error((format("Unable to copy mod's data: %1%") % std::strerror(errno)).str());
+        }
+        if (copied == 0)
+        {
+            throw std::runtime_error("Unexpected end of the pack while copying mod's data!");
+        }
+
+        offset += static_cast<uint64_t>(copied);
+        remaining -= static_cast<uint64_t>(copied);
+    }
+    return true;
+}
+
+void MCPacker::PackExtractor::Copy(int sourceFd, int jarFd, uint64_t offset, uint64_t size) const
+{
+    auto current = method.load(std::memory_order_relaxed);
+    while (not CopyWith(current, sourceFd, jarFd, offset, size))
+    {
+        current = current == Method::CopyFileRange ? Method::SendFile : Method::Buffered;
+        method.store(current, std::memory_order_relaxed);
+    }
+}
+
+void MCPacker::PackExtractor::Extract(const PackIndex::Entry& entry, const fs::path& where) const
+{
+    int blobFd = -1;
+    if (entry.blob.has_value())
+    {
+        const auto pathToBlob = entry.GetBlobPath(blobStore);
+        blobFd = open(pathToBlob.c_str(), O_RDONLY | O_CLOEXEC);
+        if (blobFd == -1)
+        {
+            const auto message = format("Unable to open file %1%: %2%") % std::quoted(pathToBlob.string()) % std::strerror(errno);
+            throw std::runtime_error(message.str());
+        }
+    }
+    else if (entry.offset > packSize or entry.storedSize > packSize - entry.offset)
+    {
+        const auto message = format("Mod %1% lies outside of the pack!") % entry.name;
+        throw std::runtime_error(message.str());
+    }
+
+    const auto pathToJar = where / entry.GetName();
+    const int jarFd = open(pathToJar.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (jarFd == -1)
+    {
+        if (blobFd != -1)
+        {
+            close(blobFd);
+        }
+        const auto message = format("Unable to create file %1%: %2%") % std::quoted(pathToJar.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+
+    try
+    {
+        if (blobFd != -1)
+        {
+            Copy(blobFd, jarFd, 0, entry.size);
+            close(blobFd);
+        }
+        else if (entry.codec != Codec::Store)
+        {
+            Decompress(entry, jarFd);
+        }
+        else
+        {
+            Copy(packFd, jarFd, entry.offset, entry.storedSize);
+        }
+    }
+    catch (...)
+    {
+        if (blobFd != -1)
+        {
+            close(blobFd);
+        }
+        close(jarFd);
+        throw;
+    }
+
+    if (close(jarFd) == -1)
+    {
+        const auto message = format("Unable to write file %1%: %2%") % std::quoted(pathToJar.string()) % std::strerror(errno);
+        throw std::runtime_error(message.str());
+    }
+}
+
+std::optional<MCPacker::IoRing::FileRange> MCPacker::PackExtractor::GetStoredRange(const PackIndex::Entry& entry) const
+{
+    if (entry.blob.has_value() or entry.codec != Codec::Store or entry.offset > packSize or entry.storedSize > packSize - entry.offset)
+    {
+        return std::nullopt;
+    }
+    return IoRing::FileRange{.fd = packFd, .offset = entry.offset, .size = entry.storedSize};
+}
+
+void MCPacker::PackExtractor::Decompress(const PackIndex::Entry& entry, int jarFd) const
+{
+    thread_local std::vector<Byte> input(BufferSize);
+    std::vector<Byte> output;
+    Decompressor decompressor(entry.codec);
+
+    uint64_t offset = entry.offset;
+    uint64_t remaining = entry.storedSize;
+    uint64_t written = 0;
+    while (remaining != 0)
+    {
+        const auto chunk = static_cast<size_t>(std::min<uint64_t>(remaining, input.size()));
+        const auto read = pread(packFd, input.data(), chunk, static_cast<off_t>(offset));
+        if (read == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error((format("Unable to read mod's data: %1%") % std::strerror(errno)).str());
+        }
+        if (read == 0)
+        {
+            throw std::runtime_error("Unexpected end of the pack while copying mod's data!");
+        }
+
+        output.clear();
+        decompressor.Decompress(std::span(input).first(static_cast<size_t>(read)), output, entry.size - written);
+        WriteAll(jarFd, output);
+
+        written += output.size();
+        offset += static_cast<uint64_t>(read);
+        remaining -= static_cast<uint64_t>(read);
+    }
+
+    if (written != entry.size)
+    {
+        const auto message = format("Mod %1% is corrupted!") % entry.name;
+        throw std::runtime_error(message.str());
+    }
+}
+
+MCPacker::PackExtractor::Method MCPacker::PackExtractor::GetMethod() const
+{
+    return method.load(std::memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACK_EXTRACTOR_HPP
+#define PACK_EXTRACTOR_HPP
+
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <boost/noncopyable.hpp>
+#include "IoRing.hpp"
+#include "PackIndex.hpp"
+
+namespace MCPacker
+{
+    /// @brief Copies mods out of a `.pck` file into `.jar` files
+    /// @details The copy is done by the kernel with `copy_file_range`, falling back to `sendfile`
+    /// and then to a buffered `pread`/`write` loop when the file systems do not support them,
+    /// so mods' data is never materialised in the process unless it has to be.
+    /// Compressed mods are decompressed chunk by chunk on the way,
+    /// and mods kept in a `BlobStore` are copied from their blobs.
+    /// `Extract` may be called from several threads at once.
+    class PackExtractor final : private boost::noncopyable
+    {
+    public:
+        enum class Method
+        {
+            CopyFileRange,
+            SendFile,
+            Buffered
+        };
+
+    private:
+        int packFd;
+        uint64_t packSize;
+        const BlobStore* blobStore;
+
+        /// @brief Fastest method known to work, it only gets slower once a method fails
+        mutable std::atomic<Method> method;
+
+        /// @brief Try copying the rest of the range with `method`
+        /// @return `false` if the method is not supported, nothing is copied in that case
+        bool CopyWith(Method method, int sourceFd, int jarFd, uint64_t& offset, uint64_t& remaining) const;
+
+        /// @brief Copy `size` bytes of `sourceFd` starting from `offset` as they are
+        void Copy(int sourceFd, int jarFd, uint64_t offset, uint64_t size) const;
+
+        void Decompress(const PackIndex::Entry& entry, int jarFd) const;
+
+    public:
+        /// @brief Open `packFile` for extraction
+        /// @param blobStore Store to copy mods from if the pack only references them
+        /// @throws std::runtime_error if the file cannot be opened
+        PackExtractor(const std::filesystem::path& packFile, const BlobStore* blobStore = nullptr);
+        ~PackExtractor();
+
+        /// @brief Write the mod described by `entry` into `where` under its own name
+        /// @param where Directory to put the mod into
+        void Extract(const PackIndex::Entry& entry, const std::filesystem::path& where) const;
+
+        /// @brief Where in the pack the data of the mod described by `entry` is, so it can be copied by other means
+        /// @return `std::nullopt` if the mod is compressed, kept in a blob or lies outside of the pack.
+        /// The range is valid as long as the extractor
+        std::optional<IoRing::FileRange> GetStoredRange(const PackIndex::Entry& entry) const;
+
+        Method GetMethod() const;
+    };
+}
+
+#endif //PACK_EXTRACTOR_HPP
\ No newline at end of file
@@ -0,0 +1,510 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <limits>
+#include <boost/format.hpp>
+#include <xxhash.h>
+#include "PackIndex.hpp"
+#include "Utility.hpp"
+
+using boost::format;
+using namespace MCPacker::Utility::Definitions;
+
+namespace
+{
+    /// @brief Flags of an entry
+    enum EntryFlags : uint8_t
+    {
+        /// @brief The mod is kept in a blob store
+        External = 1 << 0,
+        /// @brief The entry is followed by the mod's manifest
+        HasManifest = 1 << 1
+    };
+
+    using Cursor = std::vector<Byte>::const_iterator;
+
+    /// @brief Sizes come from the file, so every field is checked against what is left of the table
+    void Require(Cursor cursor, Cursor end, size_t size)
+    {
+        if (static_cast<size_t>(end - cursor) < size)
+        {
+            throw std::runtime_error("Pack's index is corrupted!");
+        }
+    }
+
+    /// @brief Deserialise the next field of an entry and advance `cursor` past it
+    template<typename T>
+    T ReadField(Cursor& cursor, Cursor end)
+    {
+        Require(cursor, end, sizeof(T));
+        std::array<Byte, sizeof(T)> serialised;
+        cursor = std::ranges::copy_n(cursor, serialised.size(), std::begin(serialised)).in;
+        return MCPacker::Utility::FromByteArray<T>(serialised);
+    }
+
+    /// @brief Deserialise a string written by `PackIndex::EncodeString` and advance `cursor` past it
+    std::string ReadStringField(Cursor& cursor, Cursor end)
+    {
+        const auto size = ReadField<uint16_t>(cursor, end);
+        Require(cursor, end, size);
+        std::string value(cursor, cursor + size);
+        if (not MCPacker::Utility::IsValidUTF8(value))
+        {
+            throw std::runtime_error("Pack's index is corrupted!");
+        }
+        cursor += size;
+        return value;
+    }
+
+    template<typename T>
+    void WriteCount(const std::vector<T>& values, std::back_insert_iterator<std::vector<Byte>>& output)
+    {
+        if (values.size() > std::numeric_limits<uint16_t>::max())
+        {
+            throw std::invalid_argument("Mod's manifest has too many entries!");
+        }
+        std::ranges::copy(MCPacker::Utility::ToByteArray(static_cast<uint16_t>(values.size())), output);
+    }
+
+    void EncodeManifest(const MCPacker::ModManifest& manifest, std::back_insert_iterator<std::vector<Byte>>& output)
+    {
+        using MCPacker::PackIndex;
+        std::ranges::copy(MCPacker::Utility::ToByteArray(static_cast<uint8_t>(manifest.loader)), output);
+        std::ranges::copy(PackIndex::EncodeString(manifest.id), output);
+        std::ranges::copy(PackIndex::EncodeString(manifest.version), output);
+
+        WriteCount(manifest.provides, output);
+        for (const auto& id : manifest.provides)
+        {
+            std::ranges::copy(PackIndex::EncodeString(id), output);
+        }
+
+        WriteCount(manifest.dependencies, output);
+        for (const auto& dependency : manifest.dependencies)
+        {
+            std::ranges::copy(PackIndex::EncodeString(dependency.id), output);
+            std::ranges::copy(PackIndex::EncodeString(dependency.versionRange), output);
+            std::ranges::copy(MCPacker::Utility::ToByteArray(static_cast<uint8_t>(dependency.kind)), output);
+        }
+    }
+
+    MCPacker::ModManifest ReadManifest(Cursor& cursor, Cursor end)
+    {
+        using MCPacker::ModManifest;
+        ModManifest manifest;
+        const auto loader = ReadField<uint8_t>(cursor, end);
+        if (loader > static_cast<uint8_t>(ModManifest::Loader::LegacyForge))
+        {
+            throw std::runtime_error("Pack's index is corrupted!");
+        }
+        manifest.loader = static_cast<ModManifest::Loader>(loader);
+        manifest.id = ReadStringField(cursor, end);
+        manifest.version = ReadStringField(cursor, end);
+
+        for (auto count = ReadField<uint16_t>(cursor, end); count != 0; --count)
+        {
+            manifest.provides.push_back(ReadStringField(cursor, end));
+        }
+
+        for (auto count = ReadField<uint16_t>(cursor, end); count != 0; --count)
+        {
+            auto id = ReadStringField(cursor, end);
+            auto versionRange = ReadStringField(cursor, end);
+            const auto kind = ReadField<uint8_t>(cursor, end);
+            if (kind > static_cast<uint8_t>(ModManifest::Dependency::Kind::Conflict))
+            {
+                throw std::runtime_error("Pack's index is corrupted!");
+            }
+            manifest.dependencies.emplace_back(std::move(id), std::move(versionRange), static_cast<ModManifest::Dependency::Kind>(kind));
+        }
+        return manifest;
+    }
+}
+
+MCPacker::PackIndex::Entry::Entry()
+    :
+    name(),
+    offset(0),
+    size(0),
+    storedSize(0),
+    codec(Codec::Store),
+    checksum(),
+    checksumAlgorithm(ChecksumAlgorithm::XXH3),
+    blob(),
+    manifest()
+{
+
+}
+
+std::u32string MCPacker::PackIndex::Entry::GetName() const
+{
+    return Utility::UTF8ToUTF32(name);
+}
+
+std::filesystem::path MCPacker::PackIndex::Entry::GetBlobPath(const BlobStore* store) const
+{
+    if (not blob.has_value())
+    {
+        throw std::logic_error("Mod is embedded into the pack!");
+    }
+    if (store == nullptr)
+    {
+        const auto message = format("Mod %1% is kept in a blob store, but none is given!") % name;
+        throw std::runtime_error(message.str());
+    }
+    return store->GetPath(*blob);
+}
+
+MCPacker::PackIndex::ChecksumAlgorithm MCPacker::PackIndex::ChecksumAlgorithmOf(uint16_t version)
+{
+    return version == LegacyVersion or version >= HashedVersion ? ChecksumAlgorithm::XXH3 : ChecksumAlgorithm::CRC32;
+}
+
+MCPacker::PackIndex::Hasher::Hasher(ChecksumAlgorithm algorithm)
+    :
+    crc(),
+    state(nullptr)
+{
+    if (algorithm == ChecksumAlgorithm::XXH3)
+    {
+        state = XXH3_createState();
+        if (state == nullptr or XXH3_64bits_reset(state) != XXH_OK)
+        {
+            XXH3_freeState(state);
+            throw std::bad_alloc();
+        }
+    }
+}
+
+MCPacker::PackIndex::Hasher::~Hasher()
+{
+    XXH3_freeState(state);
+}
+
+void MCPacker::PackIndex::Hasher::Update(std::span<const Byte> data)
+{
+    if (state != nullptr)
+    {
+        XXH3_64bits_update(state, data.data(), data.size());
+    }
+    else
+    {
+        crc.process_bytes(data.data(), data.size());
+    }
+}
+
+uint64_t MCPacker::PackIndex::Hasher::GetDigest() const
+{
+    return state != nullptr ? XXH3_64bits_digest(state) : crc.checksum();
+}
+
+MCPacker::PackIndex::PackIndex(uint16_t version)
+    :
+    version(version),
+    entries(),
+    entriesByName()
+{
+
+}
+
+bool MCPacker::PackIndex::ReadMagic(InputBinaryFile& pack)
+{
+    std::array<Byte, Magic.size()> magic;
+    magic.fill(0);
+    pack.read(magic.data(), magic.size());
+
+    if (pack.gcount() == static_cast<std::streamsize>(magic.size()) and magic == Magic)
+    {
+        return true;
+    }
+
+    pack.clear();
+    pack.seekg(0);
+    return false;
+}
+
+MCPacker::PackIndex MCPacker::PackIndex::Read(InputBinaryFile& pack, uint16_t version, Hasher* header)
+{
+    if (version == LegacyVersion or version > CurrentVersion)
+    {
+        const auto message = format("Unsupported pack format version %1%!") % version;
+        throw std::runtime_error(message.str());
+    }
+
+    PackIndex index(version);
+
+    const bool compact = version >= CompactVersion;
+    std::array<Byte, sizeof(uint64_t)> entryCountSerialised, tableSizeSerialised;
+    tableSizeSerialised.fill(0);
+    pack.read(entryCountSerialised.data(), entryCountSerialised.size());
+    if (compact)
+    {
+        pack.read(tableSizeSerialised.data(), tableSizeSerialised.size());
+    }
+    const auto entryCount = Utility::FromByteArray<uint64_t>(entryCountSerialised);
+    const auto entrySize = EntrySize(version);
+
+    // A damaged count or size must not make us allocate more than the file could possibly hold
+    const auto tableOffset = pack.tellg();
+    pack.seekg(0, std::ios::end);
+    const auto remaining = static_cast<uint64_t>(pack.tellg() - tableOffset);
+    pack.seekg(tableOffset);
+    const auto tableSize = compact ? Utility::FromByteArray<uint64_t>(tableSizeSerialised) : entryCount * entrySize;
+    if (not pack or entryCount > remaining / entrySize or tableSize > remaining)
+    {
+        throw std::runtime_error("Pack's index is truncated!");
+    }
+
+    // Read the whole table in one go, it is small compared to mods' data
+    std::vector<Byte> table(tableSize);
+    pack.read(table.data(), table.size());
+    if (not pack)
+    {
+        throw std::runtime_error("Pack's index is truncated!");
+    }
+
+    if (header != nullptr)
+    {
+        header->Update(entryCountSerialised);
+        if (compact)
+        {
+            header->Update(tableSizeSerialised);
+        }
+        header->Update(table);
+    }
+
+    index.entries.reserve(entryCount);
+    auto cursor = std::cbegin(table);
+    const auto end = std::cend(table);
+    for (uint64_t i = 0; i < entryCount; ++i)
+    {
+        Entry entry;
+        if (compact)
+        {
+            entry.name = ReadStringField(cursor, end);
+        }
+        else
+        {
+            std::array<Byte, NameLengthInBytes> name;
+            Require(cursor, end, name.size());
+            cursor = std::ranges::copy_n(cursor, name.size(), std::begin(name)).in;
+            entry.name = Utility::UTF8ArrayToString(name);
+        }
+
+        entry.offset = ReadField<uint64_t>(cursor, end);
+        entry.size = ReadField<uint64_t>(cursor, end);
+        entry.checksum = ReadField<uint64_t>(cursor, end);
+        entry.checksumAlgorithm = ChecksumAlgorithmOf(version);
+        entry.storedSize = entry.size;
+
+        if (version >= CompressedVersion)
+        {
+            const auto codec = ReadField<uint8_t>(cursor, end);
+            if (codec > static_cast<uint8_t>(Codec::Zstd))
+            {
+                throw std::runtime_error("Pack's index is corrupted!");
+            }
+            entry.codec = static_cast<Codec>(codec);
+            entry.storedSize = ReadField<uint64_t>(cursor, end);
+        }
+
+        if (version >= ContentAddressedVersion)
+        {
+            const auto flags = ReadField<uint8_t>(cursor, end);
+            BlobStore::Digest digest;
+            Require(cursor, end, digest.size());
+            cursor = std::ranges::copy_n(cursor, digest.size(), std::begin(digest)).in;
+            if (flags & EntryFlags::External)
+            {
+                entry.blob = digest;
+            }
+            if (version >= ManifestVersion and flags & EntryFlags::HasManifest)
+            {
+                entry.manifest = ReadManifest(cursor, end);
+            }
+        }
+        index.Add(std::move(entry));
+    }
+
+    if (cursor != end)
+    {
+        throw std::runtime_error("Pack's index is corrupted!");
+    }
+    return index;
+}
+
+std::vector<Byte> MCPacker::PackIndex::Encode() const
+{
+    std::vector<Byte> encoded;
+    auto output = std::back_inserter(encoded);
+
+    std::ranges::copy(Utility::ToByteArray(static_cast<uint64_t>(entries.size())), output);
+    std::fill_n(output, sizeof(uint64_t), Byte(0));
+    std::ranges::for_each(entries, 
+        [&output](const Entry& entry)
+        {
+            std::ranges::copy(EncodeString(entry.name), output);
+            std::ranges::copy(Utility::ToByteArray(entry.offset), output);
+            std::ranges::copy(Utility::ToByteArray(entry.size), output);
+            std::ranges::copy(Utility::ToByteArray(entry.checksum.value_or(0)), output);
+            std::ranges::copy(Utility::ToByteArray(static_cast<uint8_t>(entry.codec)), output);
+            std::ranges::copy(Utility::ToByteArray(entry.storedSize), output);
+            const uint8_t flags = (entry.blob.has_value() ? EntryFlags::External : 0) 
+                | (entry.manifest.has_value() ? EntryFlags::HasManifest : 0);
+            std::ranges::copy(Utility::ToByteArray(flags), output);
+            std::ranges::copy(entry.blob.value_or(BlobStore::Digest()), output);
+            if (entry.manifest.has_value())
+            {
+                EncodeManifest(*entry.manifest, output);
+            }
+        });
+
+    const auto tableSize = Utility::ToByteArray(static_cast<uint64_t>(encoded.size() - 2 * sizeof(uint64_t)));
+    std::ranges::copy(tableSize, std::begin(encoded) + sizeof(uint64_t));
+    return encoded;
+}
+
+size_t MCPacker::PackIndex::EntrySize(uint16_t version)
+{
+    size_t size = (version >= CompactVersion ? sizeof(uint16_t) : NameLengthInBytes) + 3 * sizeof(uint64_t);
+    if (version >= CompressedVersion)
+    {
+        size += sizeof(uint8_t) + sizeof(uint64_t);
+    }
+    if (version >= ContentAddressedVersion)
+    {
+        size += sizeof(uint8_t) + std::tuple_size_v<BlobStore::Digest>;
+    }
+    return size;
+}
+
+std::vector<Byte> MCPacker::PackIndex::EncodeString(std::string_view value)
+{
+    if (value.size() > std::numeric_limits<uint16_t>::max())
+    {
+        throw std::invalid_argument("String is too long!");
+    }
+
+    std::vector<Byte> encoded;
+    encoded.reserve(sizeof(uint16_t) + value.size());
+    std::ranges::copy(Utility::ToByteArray(static_cast<uint16_t>(value.size())), std::back_inserter(encoded));
+    std::ranges::copy(value, std::back_inserter(encoded));
+    return encoded;
+}
+
+std::string MCPacker::PackIndex::ReadString(InputBinaryFile& pack, Hasher* header)
+{
+    std::array<Byte, sizeof(uint16_t)> sizeSerialised;
+    pack.read(sizeSerialised.data(), sizeSerialised.size());
+    std::string value(Utility::FromByteArray<uint16_t>(sizeSerialised), '\0');
+    pack.read(value.data(), static_cast<std::streamsize>(value.size()));
+    if (not pack)
+    {
+        throw std::runtime_error("Pack's header is truncated!");
+    }
+    if (not Utility::IsValidUTF8(value))
+    {
+        throw std::runtime_error("Pack's header is corrupted!");
+    }
+
+    if (header != nullptr)
+    {
+        header->Update(sizeSerialised);
+        header->Update(value);
+    }
+    return value;
+}
+
+uint64_t MCPacker::PackIndex::Checksum(const Byte* data, size_t size, ChecksumAlgorithm algorithm)
+{
+    if (algorithm == ChecksumAlgorithm::XXH3)
+    {
+        return XXH3_64bits(data, size);
+    }
+
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+uint64_t MCPacker::PackIndex::Checksum(InputBinaryFile& stream, uint64_t size, ChecksumAlgorithm algorithm)
+{
+    Hasher hasher(algorithm);
+    std::vector<Byte> buffer(std::min<uint64_t>(size, 1 << 20));
+    while (size != 0)
+    {
+        const auto chunk = std::min<uint64_t>(size, buffer.size());
+        stream.read(buffer.data(), static_cast<std::streamsize>(chunk));
+        if (not stream)
+        {
+            throw std::runtime_error("Unexpected end of file while computing checksum!");
+        }
+        hasher.Update(std::span(buffer).first(chunk));
+        size -= chunk;
+    }
+    return hasher.GetDigest();
+}
+
+void MCPacker::PackIndex::Add(Entry entry)
+{
+    entriesByName.emplace(entry.name, entries.size());
+    entries.push_back(std::move(entry));
+}
+
+uint16_t MCPacker::PackIndex::GetVersion() const
+{
+    return version;
+}
+
+size_t MCPacker::PackIndex::GetSize() const
+{
+    return entries.size();
+}
+
+const MCPacker::PackIndex::Entry& MCPacker::PackIndex::At(size_t index) const
+{
+    return entries.at(index);
+}
+
+std::optional<size_t> MCPacker::PackIndex::Find(std::u32string_view name) const
+{
+    return Find(Utility::UTF32ToUTF8(name));
+}
+
+std::optional<size_t> MCPacker::PackIndex::Find(std::string_view name) const
+{
+    const auto entry = entriesByName.find(std::string(name));
+    if (entry == std::end(entriesByName))
+    {
+        return std::nullopt;
+    }
+    return entry->second;
+}
+
+std::vector<MCPacker::PackIndex::Entry>::const_iterator MCPacker::PackIndex::begin() const
+{
+    return std::begin(entries);
+}
+
+std::vector<MCPacker::PackIndex::Entry>::const_iterator MCPacker::PackIndex::end() const
+{
+    return std::end(entries);
+}
\ No newline at end of file
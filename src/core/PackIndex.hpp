@@ -0,0 +1,204 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACK_INDEX_HPP
+#define PACK_INDEX_HPP
+
+#include <array>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <span>
+#include <unordered_map>
+#include <boost/crc.hpp>
+#include <boost/noncopyable.hpp>
+#include <Utility.hpp>
+#include "Compression.hpp"
+#include "BlobStore.hpp"
+#include "ModManifest.hpp"
+
+typedef struct XXH3_state_s XXH3_state_t;
+
+namespace MCPacker
+{
+    /// @brief Table of contents of a `.pck` file
+    /// @details Indexed packs start with `Magic` followed by a big-endian `uint16_t` format version,
+    /// a big-endian `uint64_t` checksum of the rest of the header (since `HashedVersion`),
+    /// the pack's name and description, and then the index itself: a big-endian `uint64_t`
+    /// number of entries followed by the entries. Mods' data follows the index.
+    /// Before `CompactVersion` strings are zero-padded to their maximum length and entries have a fixed size,
+    /// since then strings are prefixed with their length, as written by `EncodeString`, and the number of entries
+    /// is followed by the size of the table in bytes.
+    /// Legacy packs have no magic and no index, so one is built while walking their records.
+    class PackIndex
+    {
+    public:
+        static constexpr size_t NameLength = 255;
+        static constexpr size_t NameLengthInBytes = NameLength * sizeof(char32_t);
+
+        /// @brief First bytes of an indexed pack. `0x89` can never start a valid UTF-8 string,
+        /// so legacy packs, which start with the pack's name, are never mistaken for indexed ones
+        static constexpr std::array<Utility::Definitions::Byte, 8> Magic = {'\x89', 'M', 'C', 'P', 'C', 'K', '\r', '\n'};
+
+        /// @brief Format version of an unindexed pack, it is never written to a file
+        static constexpr uint16_t LegacyVersion = 0;
+        /// @brief First indexed version, mods are stored as is
+        static constexpr uint16_t IndexedVersion = 1;
+        /// @brief Entries record the codec and the stored size of mods
+        static constexpr uint16_t CompressedVersion = 2;
+        /// @brief Entries may reference mods in a `BlobStore` instead of embedding them
+        static constexpr uint16_t ContentAddressedVersion = 3;
+        /// @brief Checksums are XXH3 instead of CRC-32 and the header carries one as well
+        static constexpr uint16_t HashedVersion = 4;
+        /// @brief Strings are stored with their length instead of being padded to the maximum one
+        static constexpr uint16_t CompactVersion = 5;
+        /// @brief Entries may carry the manifest of the mod
+        static constexpr uint16_t ManifestVersion = 6;
+        static constexpr uint16_t CurrentVersion = ManifestVersion;
+
+        enum class ChecksumAlgorithm : uint8_t
+        {
+            CRC32,
+            XXH3
+        };
+
+        /// @brief Algorithm of the checksums in packs of `version`.
+        /// Legacy packs carry none, so checksums computed for them use the current one
+        static ChecksumAlgorithm ChecksumAlgorithmOf(uint16_t version);
+
+        /// @brief Incremental computation of a checksum
+        /// @details XXH3 picks the widest SIMD instruction set the CPU supports at runtime
+        class Hasher final : private boost::noncopyable
+        {
+        private:
+            boost::crc_32_type crc;
+
+            /// @brief State of XXH3, `nullptr` when computing CRC-32
+            XXH3_state_t* state;
+
+        public:
+            Hasher(ChecksumAlgorithm algorithm = ChecksumAlgorithm::XXH3);
+            ~Hasher();
+
+            void Update(std::span<const Utility::Definitions::Byte> data);
+            uint64_t GetDigest() const;
+        };
+
+        struct Entry
+        {
+            /// @brief Mod's name in UTF-8 encoding
+            std::string name;
+
+            /// @brief Offset of the mod's data from the beginning of the pack
+            uint64_t offset;
+
+            /// @brief Size of the mod's data in bytes
+            uint64_t size;
+
+            /// @brief Size of the mod's data as stored in the pack, i.e. after compression
+            uint64_t storedSize;
+
+            /// @brief Codec the mod's data is stored with
+            Codec codec;
+
+            /// @brief Checksum of the mod's data before compression, legacy packs do not carry one
+            std::optional<uint64_t> checksum;
+
+            /// @brief Algorithm `checksum` is computed with
+            ChecksumAlgorithm checksumAlgorithm;
+
+            /// @brief Digest of the mod in a `BlobStore` if the mod is not embedded into the pack.
+            /// `offset` and `storedSize` are meaningless for such mods
+            std::optional<BlobStore::Digest> blob;
+
+            /// @brief Metadata the mod declares in its jar, if it has any and the pack is recent enough to carry it
+            std::optional<ModManifest> manifest;
+
+            Entry();
+
+            /// @brief Mod's name in UTF-32 encoding, it is converted on every call
+            std::u32string GetName() const;
+
+            /// @brief Path to the mod's blob in `store`
+            /// @throws std::runtime_error if there is no store to resolve the blob with
+            std::filesystem::path GetBlobPath(const BlobStore* store) const;
+        };
+
+    private:
+        uint16_t version;
+        std::vector<Entry> entries;
+        std::unordered_map<std::string, size_t> entriesByName;
+
+    public:
+        PackIndex(uint16_t version = CurrentVersion);
+
+        /// @brief Check whether `pack` starts with `Magic`
+        /// @details The stream is left positioned right after the magic if it is present,
+        /// and at the beginning of the file otherwise
+        static bool ReadMagic(Utility::Definitions::InputBinaryFile& pack);
+
+        /// @brief Read the index of an indexed pack
+        /// @param pack Stream positioned at the beginning of the index
+        /// @param header Hasher of the pack's header, the serialised index is fed to it
+        static PackIndex Read(Utility::Definitions::InputBinaryFile& pack, uint16_t version, Hasher* header = nullptr);
+
+        /// @brief Serialise the index in the current version
+        std::vector<Utility::Definitions::Byte> Encode() const;
+
+        /// @brief Size of a serialised entry in bytes.
+        /// Since `CompactVersion` it is the size of an entry with an empty name and without a manifest,
+        /// those come on top of it
+        static size_t EntrySize(uint16_t version);
+
+        /// @brief Serialise a string as a big-endian `uint16_t` length in bytes followed by its UTF-8 code units
+        /// @throws std::invalid_argument if the string is too long
+        static std::vector<Utility::Definitions::Byte> EncodeString(std::string_view value);
+
+        /// @brief Read a string serialised by `EncodeString`
+        /// @param header Hasher of the pack's header, the serialised string is fed to it
+        /// @throws std::runtime_error if the stream ends prematurely or the string is not valid UTF-8
+        static std::string ReadString(Utility::Definitions::InputBinaryFile& pack, Hasher* header = nullptr);
+
+        /// @brief Compute checksum of mod's data as stored in `Entry::checksum`
+        static uint64_t Checksum(const Utility::Definitions::Byte* data, size_t size, 
+            ChecksumAlgorithm algorithm = ChecksumAlgorithm::XXH3);
+
+        /// @brief Compute checksum of the next `size` bytes of `stream`
+        /// @throws std::runtime_error if the stream ends before that
+        static uint64_t Checksum(Utility::Definitions::InputBinaryFile& stream, uint64_t size, 
+            ChecksumAlgorithm algorithm = ChecksumAlgorithm::XXH3);
+
+        void Add(Entry entry);
+
+        uint16_t GetVersion() const;
+        size_t GetSize() const;
+        const Entry& At(size_t index) const;
+
+        /// @brief Find an entry by mod's name
+        /// @return Position of the entry or `std::nullopt` if there is no such mod
+        std::optional<size_t> Find(std::u32string_view name) const;
+        std::optional<size_t> Find(std::string_view name) const;
+
+        std::vector<Entry>::const_iterator begin() const;
+        std::vector<Entry>::const_iterator end() const;
+    };
+}
+
+#endif //PACK_INDEX_HPP
\ No newline at end of file
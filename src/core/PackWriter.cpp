@@ -0,0 +1,349 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <thread>
+#include "PackWriter.hpp"
+#include "ParallelFor.hpp"
+
+using namespace MCPacker::Utility::Definitions;
+namespace fs = std::filesystem;
+
+MCPacker::PackWriter::PackWriter(fs::path path, const ModPack::MetaInfo& metaInfo, std::vector<ModName> modNames, 
+    const CompressionOptions& compression, std::vector<std::optional<ModManifest>> manifests)
+    :
+    path(std::move(path)),
+    temporaryPath(),
+    pack(),
+    modNames(std::move(modNames)),
+    manifests(std::move(manifests)),
+    compression(compression),
+    index(),
+    header(),
+    headerChecksumOffset(0),
+    indexOffset(0),
+    offset(0),
+    finished(false)
+{
+    if (not this->manifests.empty() and this->manifests.size() != this->modNames.size())
+    {
+        throw std::invalid_argument("There must be a manifest for every mod!");
+    }
+    this->manifests.resize(this->modNames.size());
+
+    temporaryPath = this->path;
+    temporaryPath += ".tmp";
+    pack.emplace(temporaryPath);
+    pack->Write(PackIndex::Magic);
+    pack->Write(Utility::ToByteArray(PackIndex::CurrentVersion));
+    headerChecksumOffset = pack->GetPosition();
+    pack->Fill(sizeof(uint64_t), Byte(0));
+
+    const auto name = PackIndex::EncodeString(metaInfo.name);
+    const auto description = PackIndex::EncodeString(metaInfo.description);
+    pack->Write(name);
+    pack->Write(description);
+    header.Update(name);
+    header.Update(description);
+
+    // The index precedes mods' data, so room is made for it now and it is filled in at the end.
+    // Entries only differ in size by their names and manifests, which are already known
+    PackIndex placeholder;
+    for (size_t i = 0; i < this->modNames.size(); ++i)
+    {
+        PackIndex::Entry entry;
+        entry.name = this->modNames[i];
+        entry.manifest = this->manifests[i];
+        placeholder.Add(std::move(entry));
+    }
+    indexOffset = pack->GetPosition();
+    const auto indexSize = placeholder.Encode().size();
+    pack->Fill(indexSize, Byte(0));
+    offset = indexOffset + indexSize;
+}
+
+MCPacker::PackWriter::~PackWriter()
+{
+    if (not finished)
+    {
+        pack.reset();
+        std::error_code ignored;
+        fs::remove(temporaryPath, ignored);
+    }
+}
+
+void MCPacker::PackWriter::AddEntry(uint64_t size, uint64_t storedSize, Codec codec, uint64_t checksum, 
+    std::optional<BlobStore::Digest> blob)
+{
+    if (index.GetSize() == modNames.size())
+    {
+        throw std::logic_error("More mods are appended than were announced!");
+    }
+
+    PackIndex::Entry entry;
+    entry.name = modNames[index.GetSize()];
+    entry.manifest = manifests[index.GetSize()];
+    entry.offset = offset;
+    entry.size = size;
+    entry.storedSize = storedSize;
+    entry.codec = codec;
+    entry.checksum = checksum;
+    entry.blob = blob;
+    index.Add(std::move(entry));
+    offset += storedSize;
+}
+
+MCPacker::PackWriter::EncodedMod MCPacker::PackWriter::Encode(std::span<const Byte> data, const CompressionOptions& compression)
+{
+    EncodedMod encoded{.checksum = PackIndex::Checksum(data.data(), data.size()), .codec = Codec::Store, .compressed = {}};
+
+    if (compression.codec != Codec::Store)
+    {
+        auto compressed = Compressor::CompressAll(data, compression);
+        if (compressed.size() < data.size())
+        {
+            encoded.codec = compression.codec;
+            encoded.compressed = std::move(compressed);
+        }
+    }
+    return encoded;
+}
+
+void MCPacker::PackWriter::Write(std::span<const Byte> data, const EncodedMod& encoded)
+{
+    const auto stored = encoded.codec == Codec::Store ? data : std::span<const Byte>(encoded.compressed);
+    AddEntry(data.size(), stored.size(), encoded.codec, encoded.checksum);
+    pack->Write(stored);
+}
+
+void MCPacker::PackWriter::Append(std::span<const Byte> data)
+{
+    Write(data, Encode(data, compression));
+}
+
+void MCPacker::PackWriter::Append(const std::vector<std::span<const Byte>>& mods)
+{
+    const auto workerCount = ResolveWorkerCount(compression.workers, mods.size());
+    if (workerCount == 1)
+    {
+        std::ranges::for_each(mods, 
+            [this](std::span<const Byte> data)
+            {
+                Append(data);
+            });
+        return;
+    }
+
+    const size_t window = 2 * workerCount;
+    std::mutex mutex;
+    std::condition_variable progress;
+    std::vector<std::optional<EncodedMod>> encoded(mods.size());
+    size_t next = 0, written = 0;
+    std::exception_ptr error;
+
+    auto work = [&]()
+    {
+        while (true)
+        {
+            size_t i = 0;
+            {
+                std::unique_lock lock(mutex);
+                progress.wait(lock, [&]() { return error or next == mods.size() or next < written + window; });
+                if (error or next == mods.size())
+                {
+                    return;
+                }
+                i = next++;
+            }
+
+            try
+            {
+                auto result = Encode(mods[i], compression);
+                std::lock_guard lock(mutex);
+                encoded[i] = std::move(result);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(mutex);
+                if (not error)
+                {
+                    error = std::current_exception();
+                }
+            }
+            progress.notify_all();
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(workerCount);
+        for (unsigned i = 0; i < workerCount; ++i)
+        {
+            workers.emplace_back(work);
+        }
+
+        // This thread is the only one writing, so mods end up in the pack in order whatever thread compressed them
+        for (size_t i = 0; i < mods.size(); ++i)
+        {
+            EncodedMod result;
+            {
+                std::unique_lock lock(mutex);
+                progress.wait(lock, [&]() { return error or encoded[i].has_value(); });
+                if (error)
+                {
+                    break;
+                }
+                result = std::move(*encoded[i]);
+                encoded[i].reset();
+            }
+
+            try
+            {
+                Write(mods[i], result);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(mutex);
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard lock(mutex);
+                ++written;
+            }
+            progress.notify_all();
+        }
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void MCPacker::PackWriter::Append(InputBinaryFile& source)
+{
+    std::vector<Byte> chunk(ChunkSize);
+    std::vector<Byte> compressed;
+    Compressor compressor(compression);
+    PackIndex::Hasher hasher;
+    uint64_t size = 0, storedSize = 0;
+    const auto start = source.tellg();
+    const auto modOffset = pack->GetPosition();
+
+    for (bool last = false; not last; )
+    {
+        source.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        if (source.bad())
+        {
+            throw std::runtime_error("Unable to read mod's data!");
+        }
+        const auto chunkSize = static_cast<size_t>(source.gcount());
+        last = source.eof();
+
+        hasher.Update(std::span(chunk).first(chunkSize));
+        compressed.clear();
+        compressor.Compress(std::span(chunk).first(chunkSize), last, compressed);
+        pack->Write(compressed);
+
+        size += chunkSize;
+        storedSize += compressed.size();
+    }
+
+    // Whether compression pays off is only known once the whole mod went through it, as with in-memory mods
+    // a mod which did not get smaller is stored as is, so it is written again from the start of the stream
+    if (compression.codec != Codec::Store and storedSize >= size and start != InputBinaryFile::pos_type(-1))
+    {
+        pack->Truncate(modOffset);
+        source.clear();
+        source.seekg(start);
+
+        uint64_t copied = 0;
+        while (source)
+        {
+            source.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            if (source.bad())
+            {
+                throw std::runtime_error("Unable to read mod's data!");
+            }
+            const auto chunkSize = static_cast<size_t>(source.gcount());
+            pack->Write(std::span(chunk).first(chunkSize));
+            copied += chunkSize;
+        }
+        if (copied != size)
+        {
+            throw std::runtime_error("Mod's data changed while it was being written!");
+        }
+
+        AddEntry(size, size, Codec::Store, hasher.GetDigest());
+        return;
+    }
+
+    AddEntry(size, storedSize, compression.codec, hasher.GetDigest());
+}
+
+void MCPacker::PackWriter::AppendReference(uint64_t size, uint64_t checksum, const BlobStore::Digest& blob)
+{
+    AddEntry(size, 0, Codec::Store, checksum, blob);
+}
+
+void MCPacker::PackWriter::AppendReference(InputBinaryFile& source, const BlobStore& store)
+{
+    std::vector<Byte> chunk(ChunkSize);
+    BlobStore::Writer blob(store);
+    PackIndex::Hasher hasher;
+    uint64_t size = 0;
+
+    while (source)
+    {
+        source.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        if (source.bad())
+        {
+            throw std::runtime_error("Unable to read mod's data!");
+        }
+        const auto chunkSize = static_cast<size_t>(source.gcount());
+        hasher.Update(std::span(chunk).first(chunkSize));
+        blob.Write(std::span(chunk).first(chunkSize));
+        size += chunkSize;
+    }
+
+    AppendReference(size, hasher.GetDigest(), blob.Commit());
+}
+
+const MCPacker::PackIndex& MCPacker::PackWriter::Finish()
+{
+    if (index.GetSize() != modNames.size())
+    {
+        throw std::logic_error("Fewer mods are appended than were announced!");
+    }
+
+    const auto encodedIndex = index.Encode();
+    header.Update(encodedIndex);
+
+    pack->WriteAt(headerChecksumOffset, Utility::ToByteArray(header.GetDigest()));
+    pack->WriteAt(indexOffset, encodedIndex);
+    pack->Close();
+
+    // Replace the old pack atomically, so it is never lost to a failed write nor seen half-written
+    fs::rename(temporaryPath, path);
+    finished = true;
+    return index;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACK_WRITER_HPP
+#define PACK_WRITER_HPP
+
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <Utility.hpp>
+#include "ModPack.hpp"
+#include "PackIndex.hpp"
+#include "Compression.hpp"
+#include "BlobStore.hpp"
+#include "BufferedWriter.hpp"
+#include "ModManifest.hpp"
+
+namespace MCPacker
+{
+    /// @brief Writes a `.pck` file one mod at a time
+    /// @details The header and a placeholder of the index are written up front, mods' data is appended
+    /// after them and the index and the header's checksum are filled in by `Finish`. Only one chunk of a mod is held in memory
+    /// at a time when the mod is appended from a stream.
+    /// Mods are compressed according to the writer's `CompressionOptions`, a mod is stored as is
+    /// if compression does not make it smaller.
+    /// The pack is written into a temporary file next to it, which `Finish` renames over the pack,
+    /// so a pack with the same name stays intact until then and readers never see a half-written one.
+    /// If the writer is destroyed before `Finish` succeeds, the temporary file is removed.
+    class PackWriter final : private boost::noncopyable
+    {
+    public:
+        /// @brief Size of the chunks mods are copied in from streams
+        static constexpr size_t ChunkSize = 1 << 20;
+
+        /// @brief Mod's name in UTF-8 encoding
+        using ModName = std::string;
+
+        /// @brief Mod's data prepared for writing
+        struct EncodedMod
+        {
+            uint64_t checksum;
+            Codec codec;
+
+            /// @brief Compressed data, empty if the mod is stored as is
+            std::vector<Utility::Definitions::Byte> compressed;
+        };
+
+    private:
+        std::filesystem::path path;
+        std::filesystem::path temporaryPath;
+        /// @brief Output of the pack, it is opened once the arguments are known to be valid
+        std::optional<BufferedWriter> pack;
+        std::vector<ModName> modNames;
+        std::vector<std::optional<ModManifest>> manifests;
+        CompressionOptions compression;
+        PackIndex index;
+
+        /// @brief Hasher of the header, fed with the pack's name and description so far
+        PackIndex::Hasher header;
+        uint64_t headerChecksumOffset;
+        uint64_t indexOffset;
+        uint64_t offset;
+        bool finished;
+
+        void AddEntry(uint64_t size, uint64_t storedSize, Codec codec, uint64_t checksum, 
+            std::optional<BlobStore::Digest> blob = std::nullopt);
+
+        /// @brief Compute checksum of a mod and compress it, it does not touch the writer
+        static EncodedMod Encode(std::span<const Utility::Definitions::Byte> data, const CompressionOptions& compression);
+        void Write(std::span<const Utility::Definitions::Byte> data, const EncodedMod& encoded);
+
+    public:
+        /// @brief Start writing a pack
+        /// @param path File to write the pack into, it is replaced by `Finish`
+        /// @param modNames Names of all mods in the order they are going to be appended
+        /// @param compression How to compress mods' data
+        /// @param manifests Manifests of the mods in the same order, they are stored in the index.
+        /// Empty if none are known
+        /// @details Names and manifests of the mods are all the index needs to know its size in advance
+        PackWriter(std::filesystem::path path, const ModPack::MetaInfo& metaInfo, std::vector<ModName> modNames, 
+            const CompressionOptions& compression = CompressionOptions(), 
+            std::vector<std::optional<ModManifest>> manifests = {});
+        ~PackWriter();
+
+        /// @brief Append the next mod's data
+        void Append(std::span<const Utility::Definitions::Byte> data);
+
+        /// @brief Append the next several mods' data
+        /// @details Mods are compressed by `CompressionOptions::workers` threads while this thread writes
+        /// them in order as they become ready. Only a few compressed mods are held in memory at a time,
+        /// as workers wait for the writer when they get too far ahead of it
+        void Append(const std::vector<std::span<const Utility::Definitions::Byte>>& mods);
+
+        /// @brief Append the next mod's data, reading `source` until its end
+        /// @details If compression does not make the mod smaller, `source` is rewound and read again to store the mod as is
+        void Append(Utility::Definitions::InputBinaryFile& source);
+
+        /// @brief Append a reference to the next mod, which is already in a `BlobStore`
+        /// @param size Size of the mod's data
+        /// @param checksum Checksum of the mod's data as computed by `PackIndex::Checksum`
+        void AppendReference(uint64_t size, uint64_t checksum, const BlobStore::Digest& blob);
+
+        /// @brief Put the next mod into `store`, reading `source` until its end, and append a reference to it
+        void AppendReference(Utility::Definitions::InputBinaryFile& source, const BlobStore& store);
+
+        /// @brief Write the index, every mod must have been appended by now
+        /// @throws std::runtime_error if the pack cannot be written
+        const PackIndex& Finish();
+    };
+}
+
+#endif //PACK_WRITER_HPP
\ No newline at end of file
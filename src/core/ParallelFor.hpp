@@ -0,0 +1,91 @@
+/* 
+ * This file is part of the MCPacker project (https://github.com/douaumont/MCPacker).
+ * Copyright (c) 2024 Artyom Makarov.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include <atomic>
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MCPacker
+{
+    /// @brief Resolve a requested number of worker threads
+    /// @param workers Requested number of workers, `0` means one per hardware thread
+    /// @param taskCount Number of tasks, there is no point in having more workers than tasks
+    inline unsigned ResolveWorkerCount(unsigned workers, size_t taskCount)
+    {
+        if (workers == 0)
+        {
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+        return static_cast<unsigned>(std::clamp<size_t>(taskCount, 1, workers));
+    }
+
+    /// @brief Call `task(i)` for every `i` in `[0, count)` using up to `workers` threads
+    /// @param workers Refer to `ResolveWorkerCount`
+    /// @details Tasks are picked up in ascending order. Once a task throws, no new tasks are started
+    /// and the first exception is rethrown after the running ones finish
+    template<typename Task>
+    void ParallelFor(size_t count, unsigned workers, Task&& task)
+    {
+        std::atomic<size_t> next = 0;
+        std::atomic<bool> failed = false;
+        std::exception_ptr firstError;
+        std::mutex errorMutex;
+
+        auto work = [&]()
+        {
+            for (auto i = next++; i < count and not failed; i = next++)
+            {
+                try
+                {
+                    task(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(errorMutex);
+                    if (not failed.exchange(true))
+                    {
+                        firstError = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        const auto threadCount = ResolveWorkerCount(workers, count);
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(threadCount - 1);
+            for (unsigned i = 1; i < threadCount; ++i)
+            {
+                threads.emplace_back(work);
+            }
+            work();
+        }
+
+        if (firstError)
+        {
+            std::rethrow_exception(firstError);
+        }
+    }
+}
+
+#endif //PARALLEL_FOR_HPP
\ No newline at end of file
@@ -1,22 +1,45 @@
 #include <algorithm>
-#include <ranges>
-#include <core/ModPackManager.hpp>
 #include "MainFrame.hpp"
 
+wxDEFINE_EVENT(EVT_MOD_PACKS_UPDATED, wxThreadEvent);
+
 MainFrame::MainFrame()
     :
-    wxFrame(nullptr, wxID_ANY, L"MCPacker")
+    wxFrame(nullptr, wxID_ANY, L"MCPacker"),
+    modPackList(nullptr),
+    loadingProgress(nullptr),
+    listenerId(0)
 {
     wxSizer* sizer = new wxBoxSizer(wxVERTICAL);
-    modPackList = new wxListBox(this, wxID_ANY);
-    const auto& modPackManager = MCPacker::ModPackManager::Instance();
-    wxArrayString modPacks;
-    std::ranges::for_each(modPackManager.GetModPacks(), 
-        [&modPacks](const auto& modPack)
+    modPackList = new ModPackListCtrl(this);
+    loadingProgress = new wxGauge(this, wxID_ANY, 1);
+    sizer->Add(modPackList, wxSizerFlags(1).Expand());
+    sizer->Add(loadingProgress, wxSizerFlags().Expand());
+    SetSizer(sizer);
+
+    // Packs are read on the manager's threads, the frame is shown right away and fills in as they arrive
+    Bind(EVT_MOD_PACKS_UPDATED, &MainFrame::OnModPacksUpdated, this);
+    listenerId = MCPacker::ModPackManager::Instance().Subscribe(
+        [this](const std::shared_ptr<const MCPacker::ModPackManager::ModPackList>& modPacks, MCPacker::ModPackManager::Progress progress)
         {
-            modPacks.push_back(wxString::FromUTF8(modPack.GetMetaInfo().GetNameInUTF8()));
+            auto* event = new wxThreadEvent(EVT_MOD_PACKS_UPDATED);
+            event->SetPayload(ModPacksUpdate{.modPacks = modPacks, .progress = progress});
+            wxQueueEvent(this, event);
         });
-    modPackList->Append(modPacks);
-    sizer->Add(modPackList);
-    SetSizer(sizer);
+}
+
+MainFrame::~MainFrame()
+{
+    MCPacker::ModPackManager::Instance().Unsubscribe(listenerId);
+}
+
+void MainFrame::OnModPacksUpdated(wxThreadEvent& event)
+{
+    const auto update = event.GetPayload<ModPacksUpdate>();
+    modPackList->SetModPacks(update.modPacks);
+
+    loadingProgress->SetRange(static_cast<int>(std::max<size_t>(update.progress.total, 1)));
+    loadingProgress->SetValue(static_cast<int>(update.progress.loaded));
+    loadingProgress->Show(not update.progress.IsComplete());
+    Layout();
 }
\ No newline at end of file
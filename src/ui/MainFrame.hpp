@@ -1,15 +1,33 @@
 #ifndef MAIN_FRAME_HPP
 #define MAIN_FRAME_HPP
 
+#include <memory>
 #include <wx/wx.h>
+#include <core/ModPackManager.hpp>
+#include "ModPackListCtrl.hpp"
+
+/// @brief Sent from `ModPackManager`'s threads with a `MainFrame::ModPacksUpdate` payload
+wxDECLARE_EVENT(EVT_MOD_PACKS_UPDATED, wxThreadEvent);
 
 class MainFrame : public wxFrame
 {
+public:
+    struct ModPacksUpdate
+    {
+        std::shared_ptr<const MCPacker::ModPackManager::ModPackList> modPacks;
+        MCPacker::ModPackManager::Progress progress;
+    };
+
 private:
-    wxListBox* modPackList;
+    ModPackListCtrl* modPackList;
+    wxGauge* loadingProgress;
+    size_t listenerId;
+
+    void OnModPacksUpdated(wxThreadEvent& event);
 
 public:
     MainFrame();
+    ~MainFrame();
 };
 
 #endif //MAIN_FRAME_HPP
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+#include <wx/filename.h>
+#include "ModPackListCtrl.hpp"
+
+ModPackListCtrl::ModPackListCtrl(wxWindow* parent)
+    :
+    wxListCtrl(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL),
+    modPacks(std::make_shared<const MCPacker::ModPackManager::ModPackList>()),
+    sizes(),
+    rows(),
+    sortColumn(Column::Name),
+    ascending(true)
+{
+    AppendColumn(L"Name", wxLIST_FORMAT_LEFT, 240);
+    AppendColumn(L"Mods", wxLIST_FORMAT_RIGHT, 60);
+    AppendColumn(L"Size", wxLIST_FORMAT_RIGHT, 90);
+    ShowSortIndicator(sortColumn, ascending);
+    Bind(wxEVT_LIST_COL_CLICK, &ModPackListCtrl::OnColumnClick, this);
+}
+
+void ModPackListCtrl::SetModPacks(std::shared_ptr<const MCPacker::ModPackManager::ModPackList> modPacks)
+{
+    this->modPacks = std::move(modPacks);
+
+    sizes.clear();
+    sizes.reserve(this->modPacks->size());
+    std::ranges::transform(*this->modPacks, std::back_inserter(sizes), 
+        [](const std::shared_ptr<const MCPacker::ModPack>& modPack)
+        {
+            return std::accumulate(std::begin(modPack->GetIndex()), std::end(modPack->GetIndex()), uint64_t(0), 
+                [](uint64_t size, const MCPacker::PackIndex::Entry& entry)
+                {
+                    return size + entry.size;
+                });
+        });
+
+    rows.resize(this->modPacks->size());
+    std::iota(std::begin(rows), std::end(rows), size_t(0));
+    Sort();
+
+    SetItemCount(static_cast<long>(rows.size()));
+    Refresh();
+}
+
+const MCPacker::ModPack& ModPackListCtrl::GetModPack(long row) const
+{
+    return *(*modPacks)[rows.at(static_cast<size_t>(row))];
+}
+
+void ModPackListCtrl::Sort()
+{
+    const auto less = [this](size_t left, size_t right)
+    {
+        const auto& leftPack = *(*modPacks)[left];
+        const auto& rightPack = *(*modPacks)[right];
+        switch (sortColumn)
+        {
+            case Column::ModCount:
+                return leftPack.GetIndex().GetSize() < rightPack.GetIndex().GetSize();
+
+            case Column::Size:
+                return sizes[left] < sizes[right];
+
+            default:
+                return leftPack.GetMetaInfo().name < rightPack.GetMetaInfo().name;
+        }
+    };
+
+    if (ascending)
+    {
+        std::ranges::stable_sort(rows, less);
+    }
+    else
+    {
+        std::ranges::stable_sort(rows, [&less](size_t left, size_t right) { return less(right, left); });
+    }
+}
+
+void ModPackListCtrl::OnColumnClick(wxListEvent& event)
+{
+    const auto column = static_cast<Column>(event.GetColumn());
+    ascending = column == sortColumn ? not ascending : true;
+    sortColumn = column;
+
+    Sort();
+    ShowSortIndicator(sortColumn, ascending);
+    Refresh();
+}
+
+wxString ModPackListCtrl::OnGetItemText(long item, long column) const
+{
+    const auto& modPack = GetModPack(item);
+    switch (column)
+    {
+        case Column::Name:
+            return wxString::FromUTF8(modPack.GetMetaInfo().GetNameInUTF8());
+
+        case Column::ModCount:
+            return wxString::Format(L"%zu", modPack.GetIndex().GetSize());
+
+        case Column::Size:
+            return wxFileName::GetHumanReadableSize(wxULongLong(sizes[rows.at(static_cast<size_t>(item))]));
+
+        default:
+            return wxString();
+    }
+}
\ No newline at end of file
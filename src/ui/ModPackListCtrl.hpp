@@ -0,0 +1,52 @@
+#ifndef MOD_PACK_LIST_CTRL_HPP
+#define MOD_PACK_LIST_CTRL_HPP
+
+#include <memory>
+#include <vector>
+#include <wx/wx.h>
+#include <wx/listctrl.h>
+#include <core/ModPackManager.hpp>
+
+/// @brief List of packs in virtual mode
+/// @details Rows are not stored in the control, their text is made from the shown pack list
+/// when they are painted, so only visible rows cost anything. Clicking a column's header sorts
+/// the list by it, clicking it again reverses the order
+class ModPackListCtrl : public wxListCtrl
+{
+public:
+    enum Column : long
+    {
+        Name,
+        ModCount,
+        Size
+    };
+
+private:
+    std::shared_ptr<const MCPacker::ModPackManager::ModPackList> modPacks;
+
+    /// @brief Total size of every pack's mods, in the order of `modPacks`
+    std::vector<uint64_t> sizes;
+
+    /// @brief Positions in `modPacks` of the rows in the order they are shown
+    std::vector<size_t> rows;
+
+    Column sortColumn;
+    bool ascending;
+
+    void Sort();
+    void OnColumnClick(wxListEvent& event);
+
+protected:
+    wxString OnGetItemText(long item, long column) const override;
+
+public:
+    ModPackListCtrl(wxWindow* parent);
+
+    /// @brief Show `modPacks` instead of the current list, keeping the sort order
+    void SetModPacks(std::shared_ptr<const MCPacker::ModPackManager::ModPackList> modPacks);
+
+    /// @brief Pack shown in `row`
+    const MCPacker::ModPack& GetModPack(long row) const;
+};
+
+#endif //MOD_PACK_LIST_CTRL_HPP
\ No newline at end of file